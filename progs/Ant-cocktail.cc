@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <limits>
 
 
 #include "mc/pluto/PlutoGenerator.h"
@@ -14,11 +15,25 @@
 #include "base/Logger.h"
 #include "base/detail/tclap/ValuesConstraintExtra.h"
 
+#include "TRandom.h"
+
+// detail
+#include "detail/McAction.h"
+
 
 using namespace std;
 using namespace ant;
 using namespace ant::mc::pluto;
 
+struct CocktailAction : McAction {
+    vector<double> energies;
+    bool saveUnstable;
+    bool doBulk;
+    int  verbosity;
+    bool seeded;
+    virtual void Run() const override;
+};
+
 int main( int argc, char** argv )
 {
     SetupLogger();
@@ -40,6 +55,8 @@ int main( int argc, char** argv )
 
     auto cmd_noTID      = cmd.add<TCLAP::SwitchArg>        ("",  "noTID",   "Don't add TID tree for the events",   false);
     auto cmd_verbose    = cmd.add<TCLAP::ValueArg<int>>    ("v", "verbose", "Verbosity level (0..9)",              false, 0, "int");
+    auto cmd_jobs       = cmd.add<TCLAP::ValueArg<unsigned>>("j", "jobs",   "Generate in parallel worker processes, merged into one output file", false, 1, "unsigned int");
+    auto cmd_seed       = cmd.add<TCLAP::ValueArg<unsigned>>("",  "seed",   "Base seed for the random generators, random if not given", false, 0, "unsigned int");
 
     cmd.parse(argc, argv);
 
@@ -82,18 +99,27 @@ int main( int argc, char** argv )
         return 1;
     }
 
-    // scope that the Cocktail output file is properly closed before adding TID tree
-    {
-        Cocktail cocktail(outfile,
-                          energies,
-                          !cmd_noUnstable->isSet(),
-                          !cmd_noBulk->isSet(),
-                          cmd_verbose->getValue());
-
-        auto nErrors = cocktail.Sample(cmd_numEvents->getValue());
-
-        if(nErrors>0)
-            LOG(WARNING) << "Events with error: " <<  nErrors;
+    CocktailAction action;
+    action.nEvents      = cmd_numEvents->getValue();
+    action.outfile      = outfile;
+    action.energies     = energies;
+    action.saveUnstable = !cmd_noUnstable->isSet();
+    action.doBulk       = !cmd_noBulk->isSet();
+    action.verbosity    = cmd_verbose->getValue();
+    action.seeded       = cmd_seed->isSet() || cmd_jobs->getValue()>1;
+
+    if(cmd_jobs->getValue()>1) {
+        // the seeds of the jobs are derived from the base seed
+        gRandom->SetSeed(cmd_seed->getValue());
+        const unsigned seed = cmd_seed->isSet() ? cmd_seed->getValue() : gRandom->GetSeed();
+        LOG(INFO) << "Running " << cmd_jobs->getValue() << " jobs with base seed " << seed;
+        if(!action.RunParallel(cmd_jobs->getValue(), seed, outfile))
+            return EXIT_FAILURE;
+    }
+    else {
+        if(cmd_seed->isSet())
+            gRandom->SetSeed(cmd_seed->getValue());
+        action.Run();
     }
 
     // add TID tree for the generated events
@@ -104,3 +130,22 @@ int main( int argc, char** argv )
 
     return EXIT_SUCCESS;
 }
+
+void CocktailAction::Run() const
+{
+    // the Cocktail output file is closed when leaving this scope
+    Cocktail cocktail(outfile,
+                      energies,
+                      saveUnstable,
+                      doBulk,
+                      verbosity);
+
+    // derive the seed from gRandom, which is seeded per job
+    if(seeded)
+        cocktail.SetSeed(gRandom->Integer(numeric_limits<UInt_t>::max()));
+
+    auto nErrors = cocktail.Sample(nEvents);
+
+    if(nErrors>0)
+        LOG(WARNING) << "Events with error: " <<  nErrors;
+}
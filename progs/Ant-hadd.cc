@@ -12,6 +12,7 @@
 #include "TKey.h"
 #include "TClass.h"
 #include "TH1.h"
+#include "TTree.h"
 #include "TFileMergeInfo.h"
 #include "root-addons/analysis_codes/hstack.h"
 
@@ -35,6 +36,9 @@ using sources_t = unique_ptrs_t<const TDirectory>;
 
 unsigned nPaths = 0;
 
+// copy the compressed baskets of trees unchanged if compression of input and output matches
+bool fastTrees = true;
+
 template<typename T>
 struct pair_t {
     explicit pair_t(const string& name) : Name(name) {}
@@ -57,6 +61,51 @@ void add_by_name(C& c, const string& name, Args&&... args) {
     }
 }
 
+/**
+ * @brief MergeTree appends the entries of the given trees to a new tree in target
+ *
+ * Only one input tree is in memory at a time. The baskets are copied without
+ * decompressing them if the compression settings match, so this is limited by disk I/O.
+ */
+void MergeTree(TDirectory& target, const vector<TKey*>& keys)
+{
+    target.cd();
+    const auto target_compression = target.GetFile()->GetCompressionSettings();
+
+    TTree* merged = nullptr;
+    for(auto key : keys) {
+        unique_ptr<TTree> tree(dynamic_cast<TTree*>(key->ReadObj()));
+        if(!tree) {
+            LOG(WARNING) << "Cannot read tree " << key->GetName() << " from " << key->GetMotherDir()->GetPath();
+            continue;
+        }
+        if(!merged) {
+            target.cd();
+            merged = tree->CloneTree(0);
+        }
+
+        const bool fast = fastTrees && tree->GetCurrentFile()->GetCompressionSettings() == target_compression;
+        Long64_t copied = -1;
+        if(fast)
+            copied = merged->CopyEntries(tree.get(), -1, "fast");
+        if(copied < 0) {
+            if(fast)
+                LOG(WARNING) << "Fast copy of tree " << tree->GetName() << " from "
+                             << tree->GetCurrentFile()->GetName() << " failed, recompressing";
+            copied = merged->CopyEntries(tree.get());
+        }
+        VLOG(5) << "Copied " << copied << " bytes of tree " << tree->GetName()
+                << " from " << tree->GetCurrentFile()->GetName() << (fast ? " (fast)" : "");
+    }
+
+    if(!merged)
+        return;
+
+    target.WriteTObject(merged);
+    // detaches the merged tree from the target, so the final Write() does not write it again
+    delete merged;
+}
+
 void MergeRecursive(TDirectory& target, const sources_t& sources)
 {
     nPaths++;
@@ -67,6 +116,8 @@ void MergeRecursive(TDirectory& target, const sources_t& sources)
     vector<pair_t<unique_ptrs_t<TH1>>>    hists;
     vector<pair_t<unique_ptrs_t<hstack>>> stacks;
     vector<pair_t<unique_ptrs_t<TAntHeader>>> headers;
+    // trees are read one input at a time while merging, keep only the keys
+    vector<pair_t<vector<TKey*>>> trees;
 
     for(auto& source : sources) {
         TList* keys = source->GetListOfKeys();
@@ -102,6 +153,9 @@ void MergeRecursive(TDirectory& target, const sources_t& sources)
                 auto obj = dynamic_cast<TAntHeader*>(key->ReadObj());
                 add_by_name(headers, keyname, obj);
             }
+            else if(cl->InheritsFrom(TTree::Class())) {
+                add_by_name(trees, keyname, key);
+            }
         }
     }
 
@@ -145,6 +199,10 @@ void MergeRecursive(TDirectory& target, const sources_t& sources)
         first->Merge(addressof(c));
         target.WriteTObject(first.get());
     }
+
+    for(const auto& it : trees) {
+        MergeTree(target, it.Item);
+    }
 }
 
 void do_nativemode(const string& outputfile, const list<string>& inputfiles) {
@@ -214,6 +272,7 @@ int main( int argc, char **argv )
    TCLAP::CmdLine cmd("Ant-hadd - Merge ROOT objects in files", ' ', "0.1");
    auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"int");
    auto cmd_nativemode = cmd.add<TCLAP::MultiSwitchArg>("","native","Run native TFileMerger, is slow on large trees",false);
+   auto cmd_recompress = cmd.add<TCLAP::MultiSwitchArg>("","recompress","Recompress the baskets of trees instead of copying them",false);
    auto cmd_filenames  = cmd.add<TCLAP::UnlabeledMultiArg<string>>("files","ROOT files, first one is output",true,"ROOT files");
    cmd.parse(argc, argv);
    if(cmd_verbose->isSet()) {
@@ -244,10 +303,18 @@ int main( int argc, char **argv )
        exit(EXIT_SUCCESS);
    }
 
+   fastTrees = !cmd_recompress->isSet();
+
    auto outputfile = std_ext::make_unique<TFile>(outputfilename.c_str(), "RECREATE");
    sources_t sources;
    for(const auto& filename : filenames) {
-       sources.emplace_back(std_ext::make_unique<TFile>(filename.c_str(), "READ"));
+       auto inputfile = std_ext::make_unique<TFile>(filename.c_str(), "READ");
+       // use the compression of the inputs, then tree baskets can be copied unchanged
+       if(sources.empty())
+           outputfile->SetCompressionSettings(inputfile->GetCompressionSettings());
+       else if(fastTrees && inputfile->GetCompressionSettings() != outputfile->GetCompressionSettings())
+           LOG(WARNING) << "Compression of " << filename << " differs from first input, its trees will be recompressed";
+       sources.emplace_back(move(inputfile));
    }
 
    ProgressCounter::Interval = 2;
@@ -10,6 +10,7 @@
 #include "base/ProgressCounter.h"
 #include "base/std_ext/string.h"
 #include "base/Array2D.h"
+#include "base/tmpfile_t.h"
 
 #include "analysis/plot/root_draw.h"
 #include "base/BinSettings.h"
@@ -23,6 +24,13 @@
 #include "TFitResult.h"
 #include "TCanvas.h"
 
+#include <fstream>
+#include <functional>
+#include <csignal>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 using namespace ant;
 using namespace std;
 using namespace ant::analysis;
@@ -292,6 +300,187 @@ NewSigmas_t makeNewSigmas(const TH3D* pulls, const TH3D* sigmas,
 
 
 
+/**
+ * @brief The PullEntry_t struct holds what is filled into the histograms from one selected pull tree entry
+ *
+ * The entries can then be selected by worker processes, but are still filled in the original order
+ * by the main process, which keeps the histograms identical to a serial run
+ */
+struct PullEntry_t {
+    double CosTheta    = 0;
+    double E           = 0;
+    double TaggW       = 0;
+    double ShowerDepth = 0;
+    double CB_R_TAPS_L = 0;
+    vector<double> Pulls;
+    vector<double> Sigmas;
+
+    void Set(const utils::PullsWriter::PullTree_t& pulltree, unsigned nParamShowerDepth) {
+        CosTheta    = cos(pulltree.Theta);
+        E           = pulltree.E;
+        TaggW       = pulltree.TaggW;
+        ShowerDepth = pulltree.ShowerDepth;
+        CB_R_TAPS_L = pulltree.Values().at(nParamShowerDepth);
+        Pulls       = pulltree.Pulls();
+        Sigmas      = pulltree.Sigmas();
+    }
+
+    void Write(ostream& s) const {
+        write(s, CosTheta);
+        write(s, E);
+        write(s, TaggW);
+        write(s, ShowerDepth);
+        write(s, CB_R_TAPS_L);
+        write(s, Pulls);
+        write(s, Sigmas);
+    }
+
+    bool Read(istream& s) {
+        read(s, CosTheta);
+        read(s, E);
+        read(s, TaggW);
+        read(s, ShowerDepth);
+        read(s, CB_R_TAPS_L);
+        read(s, Pulls);
+        read(s, Sigmas);
+        return bool(s);
+    }
+
+private:
+    static void write(ostream& s, const double& v) {
+        s.write(reinterpret_cast<const char*>(addressof(v)), sizeof(v));
+    }
+    static void write(ostream& s, const vector<double>& v) {
+        const uint32_t n = v.size();
+        s.write(reinterpret_cast<const char*>(addressof(n)), sizeof(n));
+        s.write(reinterpret_cast<const char*>(v.data()), n*sizeof(double));
+    }
+    static void read(istream& s, double& v) {
+        s.read(reinterpret_cast<char*>(addressof(v)), sizeof(v));
+    }
+    static void read(istream& s, vector<double>& v) {
+        uint32_t n = 0;
+        s.read(reinterpret_cast<char*>(addressof(n)), sizeof(n));
+        if(!s)
+            return;
+        v.resize(n);
+        s.read(reinterpret_cast<char*>(v.data()), n*sizeof(double));
+    }
+};
+
+bool LinkPullTree(WrapTFileInput& input, const string& treename, utils::PullsWriter::PullTree_t& pulltree) {
+    TTree* tree;
+    if(!input.GetObject(treename, tree)) {
+        LOG(ERROR) << "Cannot find tree " << treename << " in " << input.FileNames();
+        return false;
+    }
+    if(!pulltree.Matches(tree)) {
+        LOG(ERROR) << "Given tree is not a PullTree_t";
+        return false;
+    }
+    pulltree.LinkBranches(tree);
+    return true;
+}
+
+/**
+ * @brief SelectParallel splits the entries into nJobs ranges, which are read and selected by forked worker processes.
+ * The selected entries are passed to fill in the original tree order after all workers finished.
+ * @return true if all workers succeeded
+ */
+bool SelectParallel(const string& inputfile, const string& treename,
+                    long long max_entries, double fitprob_cut, unsigned nParamShowerDepth,
+                    unsigned nJobs,
+                    const function<void(const PullEntry_t&)>& fill)
+{
+    tmpfolder_t tmpfolder;
+    vector<string> partfiles;
+    vector<pid_t> pids;
+
+    // stop and reap the workers started so far, their part files are incomplete
+    auto abort_jobs = [&pids, &partfiles] () {
+        for(auto pid : pids)
+            kill(pid, SIGTERM);
+        for(auto pid : pids)
+            waitpid(pid, nullptr, 0);
+        for(const auto& partfile : partfiles)
+            std::remove(partfile.c_str());
+    };
+
+    for(unsigned job=0;job<nJobs;job++) {
+        const long long begin = max_entries*job/nJobs;
+        const long long end   = max_entries*(job+1)/nJobs;
+        const string partfile = formatter() << tmpfolder.foldername << "/part" << job << ".dat";
+        partfiles.emplace_back(partfile);
+
+        const pid_t pid = fork();
+        if(pid < 0) {
+            LOG(ERROR) << "Could not fork worker process for job " << job;
+            abort_jobs();
+            return false;
+        }
+        if(pid == 0) {
+            // in child process, open the input again
+            // as the file offset of the parent's input would be shared
+            try {
+                WrapTFileInput input(inputfile);
+                utils::PullsWriter::PullTree_t pulltree;
+                if(!LinkPullTree(input, treename, pulltree))
+                    _exit(EXIT_FAILURE);
+
+                ofstream out(partfile, ios::binary);
+                PullEntry_t e;
+                for(long long entry=begin;entry<end;entry++) {
+                    if(interrupt)
+                        break;
+                    pulltree.Tree->GetEntry(entry);
+                    if(pulltree.FitProb > fitprob_cut) {
+                        e.Set(pulltree, nParamShowerDepth);
+                        e.Write(out);
+                    }
+                }
+                out.close();
+                // skip the destructors of the parent's objects
+                _exit(out ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+            catch(const std::exception& e) {
+                LOG(ERROR) << "Job " << job << " failed: " << e.what();
+                _exit(EXIT_FAILURE);
+            }
+        }
+        VLOG(1) << "Started job " << job << " (pid=" << pid << ") for entries "
+                << begin << " to " << end;
+        pids.push_back(pid);
+    }
+
+    bool success = true;
+    for(unsigned job=0;job<pids.size();job++) {
+        int status = 0;
+        waitpid(pids[job], addressof(status), 0);
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            LOG(ERROR) << "Job " << job << " failed";
+            success = false;
+        }
+    }
+    if(!success) {
+        // all workers are reaped already
+        pids.clear();
+        abort_jobs();
+        return false;
+    }
+
+    LOG(INFO) << "All " << nJobs << " jobs finished, filling histograms";
+
+    for(const auto& partfile : partfiles) {
+        ifstream in(partfile, ios::binary);
+        PullEntry_t e;
+        while(e.Read(in))
+            fill(e);
+        std::remove(partfile.c_str());
+    }
+
+    return true;
+}
+
 int main( int argc, char** argv )
 {
     SetupLogger();
@@ -311,6 +500,7 @@ int main( int argc, char** argv )
     auto cmd_fitprob_cut  = cmd.add<TCLAP::ValueArg<double>>("", "fitprob_cut" ,"Min. required Fit Probability",                 false, 0.01,"probability");
     auto cmd_integral_cut = cmd.add<TCLAP::ValueArg<double>>("", "integral_cut","Min. required integral in Bins",                false, 100.0,"integral");
     auto cmd_show_plots   = cmd.add<TCLAP::MultiSwitchArg>  ("", "show_plots"  ,"Show detail plots for each parameter",          false);
+    auto cmd_jobs         = cmd.add<TCLAP::ValueArg<unsigned>>("j","jobs",     "Read the pull tree in parallel worker processes", false, 1, "unsigned int");
 
     cmd.parse(argc, argv);
 
@@ -321,18 +511,9 @@ int main( int argc, char** argv )
 
     WrapTFileInput input(cmd_input->getValue());
 
-    TTree* tree;
-    if(!input.GetObject(cmd_tree->getValue(), tree)) {
-        LOG(ERROR) << "Cannot find tree " << cmd_tree->getValue() << " in " << cmd_input->getValue();
-        exit(EXIT_FAILURE);
-    }
-
     utils::PullsWriter::PullTree_t pulltree;
-    if(!pulltree.Matches(tree)) {
-        LOG(ERROR) << "Given tree is not a PullTree_t";
+    if(!LinkPullTree(input, cmd_tree->getValue(), pulltree))
         exit(EXIT_FAILURE);
-    }
-    pulltree.LinkBranches(tree);
     auto entries = pulltree.Tree->GetEntries();
 
     unique_ptr<WrapTFileOutput> masterFile;
@@ -453,36 +634,51 @@ int main( int argc, char** argv )
         LOG(INFO) << "Running until " << max_entries;
     }
 
-    long long entry = 0;
-    ProgressCounter::Interval = 3;
-    ProgressCounter progress(
-                [&entry, entries] (std::chrono::duration<double>) {
-        LOG(INFO) << "Processed " << 100.0*entry/entries << " %";
-    });
-
-    for(entry=0;entry<max_entries;entry++) {
-        if(interrupt)
-            break;
-
-        progress.Tick();
-        pulltree.Tree->GetEntry(entry);
+    auto fill_hists = [&] (const PullEntry_t& e) {
+        for(auto n=0u;n<e.Pulls.size();n++) {
+            h_pulls.at(n)->Fill(e.CosTheta, e.E,
+                                e.Pulls[n], e.TaggW);
+        }
 
-        if(pulltree.FitProb > fitprob_cut ) {
+        for(auto n=0u;n<e.Sigmas.size();n++) {
+            h_sigmas.at(n)->Fill(e.CosTheta, e.E,
+                                 e.Sigmas[n], e.TaggW);
+        }
 
-            for(auto n=0u;n<pulltree.Pulls().size();n++) {
-                h_pulls.at(n)->Fill(cos(pulltree.Theta), pulltree.E,
-                                    pulltree.Pulls().at(n), pulltree.TaggW);
-            }
+        h_CB_R_TAPS_L->Fill(e.CosTheta, e.E,
+                            e.CB_R_TAPS_L, e.TaggW);
+        h_OldShowerDepth->Fill(e.CosTheta, e.E,
+                               e.ShowerDepth, e.TaggW);
+    };
 
-            for(auto n=0u;n<pulltree.Sigmas().size();n++) {
-                h_sigmas.at(n)->Fill(cos(pulltree.Theta), pulltree.E,
-                                     pulltree.Sigmas().at(n), pulltree.TaggW);
+    const auto nJobs = cmd_jobs->getValue();
+    if(nJobs>1) {
+        LOG(INFO) << "Reading with " << nJobs << " jobs";
+        if(!SelectParallel(cmd_input->getValue(), treename,
+                           max_entries, fitprob_cut, nParamShowerDepth,
+                           nJobs, fill_hists))
+            exit(EXIT_FAILURE);
+    }
+    else {
+        long long entry = 0;
+        ProgressCounter::Interval = 3;
+        ProgressCounter progress(
+                    [&entry, entries] (std::chrono::duration<double>) {
+            LOG(INFO) << "Processed " << 100.0*entry/entries << " %";
+        });
+
+        PullEntry_t e;
+        for(entry=0;entry<max_entries;entry++) {
+            if(interrupt)
+                break;
+
+            progress.Tick();
+            pulltree.Tree->GetEntry(entry);
+
+            if(pulltree.FitProb > fitprob_cut ) {
+                e.Set(pulltree, nParamShowerDepth);
+                fill_hists(e);
             }
-
-            h_CB_R_TAPS_L->Fill(cos(pulltree.Theta), pulltree.E,
-                                pulltree.Values().at(nParamShowerDepth), pulltree.TaggW);
-            h_OldShowerDepth->Fill(cos(pulltree.Theta), pulltree.E,
-                                   pulltree.ShowerDepth, pulltree.TaggW);
         }
     }
 
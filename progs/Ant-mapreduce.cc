@@ -0,0 +1,352 @@
+/**
+  * @file Ant-mapreduce.cc
+  * @brief Run a command on many input files on the local machine and merge the outputs.
+  *
+  *        Single-node replacement for extra/AntMapReduce: The map command is run for each
+  *        input file in a pool of at most --jobs processes, failed files are retried.
+  *        Finished outputs are merged by Ant-hadd in groups of --mult files as soon as
+  *        they are available, so the reduction overlaps with the remaining map jobs.
+  */
+
+#include "base/CmdLine.h"
+#include "base/Logger.h"
+#include "base/tmpfile_t.h"
+#include "base/std_ext/string.h"
+#include "base/std_ext/system.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <list>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <csignal>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace ant;
+
+static volatile bool interrupt = false;
+
+struct job_t {
+    enum class type_t {
+        Map, Reduce
+    };
+    type_t Type;
+    vector<string> Inputs;
+    string Output;
+    string LogFile;
+    unsigned Attempts = 0;
+
+    job_t(type_t type, vector<string> inputs, string output, string logfile) :
+        Type(type), Inputs(move(inputs)), Output(move(output)), LogFile(move(logfile))
+    {}
+
+    string Name() const {
+        if(Type == type_t::Map)
+            return Inputs.front();
+        return std_ext::formatter() << "reduce of " << Inputs.size() << " files into " << Output;
+    }
+};
+
+/**
+ * @brief quote a string for /bin/sh
+ */
+string shell_quote(const string& s) {
+    string q = "'";
+    for(auto c : s) {
+        if(c == '\'')
+            q += "'\\''";
+        else
+            q += c;
+    }
+    return q + "'";
+}
+
+string replace_all(string s, const string& what, const string& with) {
+    size_t pos = 0;
+    while((pos = s.find(what, pos)) != string::npos) {
+        s.replace(pos, what.length(), with);
+        pos += with.length();
+    }
+    return s;
+}
+
+bool file_exists(const string& filename) {
+    struct stat buf;
+    return stat(filename.c_str(), &buf) == 0 && S_ISREG(buf.st_mode);
+}
+
+/**
+ * @brief spawn runs the command in /bin/sh with stdout and stderr redirected to logfile
+ * @return pid of child, or -1 on error
+ */
+pid_t spawn(const string& command, const string& logfile) {
+    const pid_t pid = fork();
+    if(pid != 0)
+        return pid;
+
+    // in child process, don't inherit our interrupt handler
+    signal(SIGINT, SIG_DFL);
+    const int fd = open(logfile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd >= 0) {
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+    }
+    const int devnull = open("/dev/null", O_RDONLY);
+    if(devnull >= 0) {
+        dup2(devnull, STDIN_FILENO);
+        close(devnull);
+    }
+    execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+    _exit(127);
+}
+
+void log_tail(const string& logfile, unsigned nLines = 10) {
+    ifstream log(logfile);
+    deque<string> lines;
+    string line;
+    while(getline(log, line)) {
+        lines.emplace_back(move(line));
+        if(lines.size() > nLines)
+            lines.pop_front();
+    }
+    for(auto& l : lines)
+        LOG(ERROR) << "  | " << l;
+}
+
+int main(int argc, char** argv) {
+    SetupLogger();
+
+    signal(SIGINT, [] (int) {
+        LOG(INFO) << ">>> Interrupted, waiting for running jobs";
+        interrupt = true;
+    });
+
+    TCLAP::CmdLine cmd("Ant-mapreduce", ' ', "0.1");
+    auto cmd_map      = cmd.add<TCLAP::ValueArg<string>>("","map","Map command, {in} and {out} are replaced by input and output file. "
+                                                         "If not present, '-i {in} -o {out}' is appended.",true,"","command");
+    auto cmd_output   = cmd.add<TCLAP::ValueArg<string>>("o","output","Merged output file",true,"","filename");
+    auto cmd_filelist = cmd.add<TCLAP::ValueArg<string>>("","filelist","File with one input file per line, '-' for stdin. Used if no inputs are given.",false,"-","filename");
+    auto cmd_jobs     = cmd.add<TCLAP::ValueArg<unsigned>>("j","jobs","Max. number of concurrently running jobs",false,
+                                                           max<unsigned>(sysconf(_SC_NPROCESSORS_ONLN), 1u),"unsigned int");
+    auto cmd_retries  = cmd.add<TCLAP::ValueArg<unsigned>>("","retries","Retry failed map jobs that often",false,2,"unsigned int");
+    auto cmd_mult     = cmd.add<TCLAP::ValueArg<unsigned>>("","mult","Number of files merged by one reduce job",false,10,"unsigned int");
+    auto cmd_hadd     = cmd.add<TCLAP::ValueArg<string>>("","hadd","Reduce command, gets output and input files as arguments",false,"Ant-hadd","command");
+    auto cmd_logdir   = cmd.add<TCLAP::ValueArg<string>>("","logdir","Keep the job logs in this (existing) directory",false,"","directory");
+    auto cmd_inputs   = cmd.add<TCLAP::UnlabeledMultiArg<string>>("inputs","Input files",false,"inputs");
+
+    cmd.parse(argc, argv);
+
+    const auto nJobs = max(cmd_jobs->getValue(), 1u);
+    const auto mult  = max(cmd_mult->getValue(), 2u);
+    const auto nRetries = cmd_retries->getValue();
+    const auto& outputfile = cmd_output->getValue();
+
+    string map_cmd = cmd_map->getValue();
+    if(map_cmd.find("{in}") == string::npos && map_cmd.find("{out}") == string::npos)
+        map_cmd += " -i {in} -o {out}";
+
+    vector<string> inputs = cmd_inputs->getValue();
+    if(inputs.empty()) {
+        const auto& filelist = cmd_filelist->getValue();
+        ifstream file;
+        if(filelist != "-") {
+            file.open(filelist);
+            if(!file) {
+                LOG(ERROR) << "Cannot open filelist " << filelist;
+                return EXIT_FAILURE;
+            }
+        }
+        istream& in = filelist == "-" ? cin : file;
+        string line;
+        while(getline(in, line)) {
+            line = std_ext::string_sanitize(line.c_str());
+            if(!line.empty())
+                inputs.emplace_back(line);
+        }
+    }
+    if(inputs.empty()) {
+        LOG(ERROR) << "No input files given";
+        return EXIT_FAILURE;
+    }
+
+    tmpfolder_t workdir;
+    const auto logdir = cmd_logdir->isSet() ? cmd_logdir->getValue() : workdir.foldername;
+
+    unsigned nMapped = 0;
+    unsigned nReduced = 0;
+    deque<job_t> pending;
+    for(unsigned i=0;i<inputs.size();i++) {
+        pending.emplace_back(job_t::type_t::Map, vector<string>{inputs[i]},
+                             std_ext::formatter() << workdir.foldername << "/map_" << i << ".root",
+                             std_ext::formatter() << logdir << "/map_" << i << ".log");
+    }
+
+    // outputs of finished jobs, waiting to be reduced
+    vector<string> finished;
+    map<pid_t, job_t> running;
+    list<job_t> failed;
+    unsigned nReduceJobs = 0;
+    bool final_started = false;
+
+    auto start = [&] (job_t job) {
+        string command;
+        if(job.Type == job_t::type_t::Map) {
+            command = replace_all(map_cmd, "{in}", shell_quote(job.Inputs.front()));
+            command = replace_all(command, "{out}", shell_quote(job.Output));
+        }
+        else {
+            command = cmd_hadd->getValue() + " " + shell_quote(job.Output);
+            for(auto& input : job.Inputs)
+                command += " " + shell_quote(input);
+        }
+        job.Attempts++;
+        const pid_t pid = spawn(command, job.LogFile);
+        if(pid < 0) {
+            LOG(ERROR) << "Could not fork for " << job.Name();
+            return false;
+        }
+        VLOG(1) << "Started (pid=" << pid << "): " << command;
+        running.emplace(pid, move(job));
+        return true;
+    };
+
+    auto make_reduce = [&] (vector<string> reduce_inputs, const string& output) {
+        const unsigned n = nReduceJobs++;
+        return job_t(job_t::type_t::Reduce, move(reduce_inputs),
+                     output.empty() ? string(std_ext::formatter() << workdir.foldername << "/reduce_" << n << ".root") : output,
+                     std_ext::formatter() << logdir << "/reduce_" << n << ".log");
+    };
+
+    LOG(INFO) << "Processing " << inputs.size() << " files with " << nJobs << " jobs";
+
+    while(true) {
+        // schedule as many jobs as allowed, prefer reducing to keep the number of intermediate files low
+        while(!interrupt && running.size() < nJobs) {
+            const bool maps_done = pending.empty() && none_of(running.begin(), running.end(),
+                                                              [] (const pair<const pid_t, job_t>& r) {
+                return r.second.Type == job_t::type_t::Map;
+            });
+            if(finished.size() >= mult) {
+                vector<string> batch(finished.end()-mult, finished.end());
+                finished.resize(finished.size()-mult);
+                // the last batch goes directly into the final output
+                const bool final = maps_done && running.empty() && finished.empty();
+                if(!start(make_reduce(move(batch), final ? outputfile : "")))
+                    break;
+                final_started |= final;
+            }
+            else if(!pending.empty()) {
+                auto job = move(pending.front());
+                pending.pop_front();
+                if(!start(move(job)))
+                    break;
+            }
+            else if(maps_done && running.empty() && finished.size() > 1 && !final_started) {
+                if(!start(make_reduce(move(finished), outputfile)))
+                    break;
+                finished.clear();
+                final_started = true;
+            }
+            else {
+                break;
+            }
+        }
+
+        if(running.empty())
+            break;
+
+        int status = 0;
+        const pid_t pid = waitpid(-1, addressof(status), 0);
+        if(pid < 0) {
+            if(errno == EINTR)
+                continue;
+            LOG(ERROR) << "waitpid failed";
+            return EXIT_FAILURE;
+        }
+        auto it = running.find(pid);
+        if(it == running.end())
+            continue;
+        auto job = move(it->second);
+        running.erase(it);
+
+        const bool success = WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS
+                             && file_exists(job.Output);
+
+        if(success) {
+            if(job.Type == job_t::type_t::Map) {
+                ++nMapped;
+                LOG(INFO) << "Finished " << nMapped << "/" << inputs.size() << ": " << job.Name();
+            }
+            else {
+                ++nReduced;
+                VLOG(1) << "Finished " << job.Name();
+                // intermediate files are not needed anymore
+                for(auto& input : job.Inputs)
+                    std::remove(input.c_str());
+            }
+            if(job.Output != outputfile)
+                finished.emplace_back(job.Output);
+            continue;
+        }
+
+        if(job.Type == job_t::type_t::Map && job.Attempts <= nRetries && !interrupt) {
+            LOG(WARNING) << "Failed (attempt " << job.Attempts << "), retrying: " << job.Name();
+            pending.emplace_front(move(job));
+            continue;
+        }
+
+        LOG(ERROR) << "Failed: " << job.Name() << ", log " << job.LogFile << ":";
+        log_tail(job.LogFile);
+        if(job.Type == job_t::type_t::Reduce) {
+            // the inputs of a failed reduce might be partially merged already,
+            // so give up instead of producing an incomplete output
+            LOG(ERROR) << "Reduce failed, aborting";
+            for(auto& r : running)
+                kill(r.first, SIGTERM);
+            while(wait(nullptr) > 0);
+            return EXIT_FAILURE;
+        }
+        failed.emplace_back(move(job));
+    }
+
+    if(interrupt) {
+        LOG(ERROR) << "Interrupted, no output written";
+        return EXIT_FAILURE;
+    }
+
+    // a single finished file was never reduced, simply move it
+    if(!final_started && finished.size() == 1) {
+        if(std::rename(finished.front().c_str(), outputfile.c_str()) != 0) {
+            const string cmd_mv = "mv " + shell_quote(finished.front()) + " " + shell_quote(outputfile);
+            if(system(cmd_mv.c_str()) != 0) {
+                LOG(ERROR) << "Could not move " << finished.front() << " to " << outputfile;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    else if(!final_started) {
+        LOG(ERROR) << "No map job succeeded, no output written";
+        return EXIT_FAILURE;
+    }
+
+    LOG(INFO) << "Merged " << nMapped << " files with " << nReduced << " reduce jobs into " << outputfile;
+
+    if(!failed.empty()) {
+        LOG(ERROR) << failed.size() << " files failed and are missing in the output:";
+        for(auto& job : failed)
+            LOG(ERROR) << "  " << job.Name();
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -91,6 +91,8 @@ int main( int argc, char** argv ) {
     auto cmd_Emax      = cmd.add<TCLAP::ValueArg<double>>    ("",  "Emax", "Maximal incident energy [MeV]", false, 1.6*GeV, "double [MeV]");
     auto cmd_noTID     = cmd.add<TCLAP::SwitchArg>           ("",  "noTID", "Don't add TID tree for the events", false);
     auto cmd_verbose   = cmd.add<TCLAP::ValueArg<int>>       ("v", "verbose","Verbosity level (0..9)", false, 0,"int");
+    auto cmd_jobs      = cmd.add<TCLAP::ValueArg<unsigned>>  ("j", "jobs", "Generate in parallel worker processes, merged into one output file", false, 1, "unsigned int");
+    auto cmd_seed      = cmd.add<TCLAP::ValueArg<unsigned>>  ("",  "seed", "Base seed for the random generators, random if not given", false, 0, "unsigned int");
 
     // reaction simulation options
     auto cmd_reaction = cmd.add<TCLAP::ValueArg<string>> ("", "reaction", "Pseudo Beam - decay string (reaction string), e.g. 'p pi0 [g g]' for pion photoproduction", true, "", "g p decay string");
@@ -126,10 +128,22 @@ int main( int argc, char** argv ) {
     action.Emax    = cmd_Emax->getValue();
 
     VLOG(2) << "gRandom is a " << gRandom->ClassName();
-    gRandom->SetSeed();
+    gRandom->SetSeed(cmd_seed->getValue());
     VLOG(2) << "gRandom initialized";
 
-    action.Run();
+    if(cmd_jobs->getValue()>1) {
+        // the seeds of the jobs are derived from the base seed
+        const unsigned seed = cmd_seed->isSet() ? cmd_seed->getValue() : gRandom->GetSeed();
+        LOG(INFO) << "Running " << cmd_jobs->getValue() << " jobs with base seed " << seed;
+        string outfile = action.outfile;
+        if(!string_ends_with(outfile, ".root"))
+            outfile += ".root";
+        if(!action.RunParallel(cmd_jobs->getValue(), seed, outfile))
+            return EXIT_FAILURE;
+    }
+    else {
+        action.Run();
+    }
 
     LOG(INFO) << "Simulation finished.";
 
@@ -9,6 +9,7 @@
 #include "analysis/input/goat/GoatReader.h"
 #include "analysis/input/pluto/PlutoReader.h"
 #include "analysis/utils/ParticleID.h"
+#include "analysis/utils/uncertainties/Interpolated.h"
 #include "analysis/physics/PhysicsManager.h"
 
 #include "expconfig/ExpConfig.h"
@@ -18,11 +19,13 @@
 #include "calibration/DataBase.h"
 
 #include "unpacker/Unpacker.h"
+#include "unpacker/UnpackerAcqu.h"
 #include "unpacker/RawFileReader.h"
 
 #include "reconstruct/Reconstruct.h"
 
 #include "tree/TAntHeader.h"
+#include "tree/TEventData.h"
 
 #include "base/std_ext/vector.h"
 #include "base/WrapTFile.h"
@@ -32,6 +35,8 @@
 #include "base/WrapTFile.h"
 #include "base/std_ext/system.h"
 #include "base/GitInfo.h"
+#include "base/StageTimer.h"
+#include "base/OutputProfile.h"
 
 #include "TRint.h"
 #include "TSystem.h"
@@ -109,11 +114,16 @@ int main(int argc, char** argv) {
     auto cmd_setupOptions = cmd.add<TCLAP::MultiArg<string>>("S","setup_options","Options for setup, key=value",false,"");
 
     auto cmd_maxevents = cmd.add<TCLAP::MultiArg<int>>("m","maxevents","Process only max events",false,"maxevents");
+    auto cmd_entryrange = cmd.add<TCLAP::ValueArg<string>>("","entry-range","Read only entries begin:end (end exclusive) of treeEvents, counted over all input files",false,"","begin:end");
+    auto cmd_shard = cmd.add<TCLAP::ValueArg<string>>("","shard","Read only the i-th of N equal parts of treeEvents, counted over all input files",false,"","i/N");
 
     TCLAP::ValuesConstraintExtra<decltype(analysis::PhysicsRegistry::GetList())> allowedPhysics(analysis::PhysicsRegistry::GetList());
     auto cmd_physicsclasses  = cmd.add<TCLAP::MultiArg<string>>("p","physics","Physics class to run", false, &allowedPhysics);
 
     auto cmd_output = cmd.add<TCLAP::ValueArg<string>>("o","output","Output file",false,"","filename");
+    TCLAP::ValuesConstraintExtra<decltype(OutputProfile::GetNames())> allowedOutputProfiles(OutputProfile::GetNames());
+    auto cmd_outputProfile = cmd.add<TCLAP::ValueArg<string>>("","output-profile","Compression and basket sizes of output trees",false,"",&allowedOutputProfiles);
+    auto cmd_outputTreeProfiles = cmd.add<TCLAP::MultiArg<string>>("","output-tree-profile","Profile for single output tree, treename=profile",false,"");
 
     auto cmd_physicsOptions = cmd.add<TCLAP::MultiArg<string>>("O","options","Options for all physics classes, key=value",false,"");
     auto cmd_physicsclasses_opt = cmd.add<TCLAP::MultiArg<string>>("P","physics-opt","Physics class to run, with options: PhysicsClass:key=val,key=val", false, "");
@@ -122,10 +132,20 @@ int main(int argc, char** argv) {
 
     auto cmd_calibrations  = cmd.add<TCLAP::MultiArg<string>>("c","calibration","Calibration to run",false,"calibration");
 
+    auto cmd_timing  = cmd.add<TCLAP::SwitchArg>("","timing","Measure time spent in each stage (unpacker, calibrations, physics classes, ...) and print summary",false);
+    auto cmd_timing_trace  = cmd.add<TCLAP::ValueArg<string>>("","timing_trace","Write per-event timing trace in Chrome trace JSON format (implies --timing)",false,"","filename");
+
     auto cmd_u_disablerecon  = cmd.add<TCLAP::SwitchArg>("","u_disablereconstruct","Unpacker: Disable Reconstruct (disables also all analysis)",false);
+    auto cmd_u_scalersonly  = cmd.add<TCLAP::SwitchArg>("","u_scalersonly","Unpacker: Only unpack scalers and slowcontrol, skip all ADC hits",false);
+    auto cmd_u_prefilterCBEsum  = cmd.add<TCLAP::ValueArg<double>>("","u_prefilterCBEsum","Unpacker: Skip reconstruction and physics for events with CB energy sum below threshold",false,0,"MeV");
 
     auto cmd_p_disableParticleID  = cmd.add<TCLAP::SwitchArg>("","p_disableParticleID","Physics: Disable ParticleID",false);
     auto cmd_p_simpleParticleID  = cmd.add<TCLAP::SwitchArg>("","p_simpleParticleID","Physics: Use simple ParticleID (just protons/photons)",false);
+    auto cmd_p_saveEventList  = cmd.add<TCLAP::SwitchArg>("","p_saveEventList","Physics: Save events as list of entries into the input treeEvents instead of full copies",false);
+    auto cmd_p_saveCalibrationCache  = cmd.add<TCLAP::SwitchArg>("","p_saveCalibrationCache","Physics: Save uncalibrated hits of all events as calibration cache, which can be used as input to iterate calibrations without unpacking again",false);
+    auto cmd_p_deferDecode  = cmd.add<TCLAP::SwitchArg>("","p_deferDecode","Physics: Decode DetectorReadHits, SlowControls and UnpackerMessages of read treeEvents only if needed, see Physics::GetNeededSections",false);
+    auto cmd_p_asyncSave  = cmd.add<TCLAP::SwitchArg>("","p_asyncSave","Physics: Compress and write saved treeEvents in a separate process while events are processed",false);
+    auto cmd_p_uncertaintyLUT  = cmd.add<TCLAP::ValueArg<unsigned>>("","p_uncertaintyLUT","Physics: Bake interpolated uncertainties into lookup tables with NxN points (0=disabled)",false,0,"N");
 
 
 
@@ -173,9 +193,17 @@ int main(int argc, char** argv) {
 
     // check if there's a previous AntHeader present,
     // which could tell us the SetupName
-    TAntHeader* previous_AntHeader;
-    if(rootfiles->GetObject<TAntHeader>("AntHeader",previous_AntHeader)) {
-        const auto& setupname = previous_AntHeader->SetupName;
+    // (there might be many when reading treeEvents from several files)
+    const auto previous_AntHeaders = rootfiles->GetObjects<TAntHeader>("AntHeader");
+    if(!previous_AntHeaders.empty()) {
+        const auto& setupname = previous_AntHeaders.front()->SetupName;
+        for(auto header : previous_AntHeaders) {
+            if(header->SetupName != setupname) {
+                LOG(ERROR) << "Found AntHeaders with different SetupNames '" << setupname
+                           << "' and '" << header->SetupName << "' in input files";
+                return EXIT_FAILURE;
+            }
+        }
         if(!setupname.empty()) {
             ExpConfig::Setup::SetManualName(setupname);
             LOG(INFO) << "Setup name set to '" << setupname << "' from input file";
@@ -184,6 +212,31 @@ int main(int argc, char** argv) {
             LOG(WARNING) << "Found AntHeader in input files, but SetupName was empty";
     }
 
+    if(cmd_entryrange->isSet()) {
+        auto& selection = analysis::input::AntReader::EntrySelection;
+        long long begin = 0, end = 0;
+        char sep = 0;
+        stringstream ss(cmd_entryrange->getValue());
+        if(!(ss >> begin >> sep >> end) || sep != ':' || begin<0 || end<begin) {
+            LOG(ERROR) << "Invalid entry range '" << cmd_entryrange->getValue() << "', expected begin:end";
+            return EXIT_FAILURE;
+        }
+        selection.Begin = begin;
+        selection.End = end;
+    }
+    if(cmd_shard->isSet()) {
+        auto& selection = analysis::input::AntReader::EntrySelection;
+        unsigned shard = 0, shards = 0;
+        char sep = 0;
+        stringstream ss(cmd_shard->getValue());
+        if(!(ss >> shard >> sep >> shards) || sep != '/' || shard >= shards) {
+            LOG(ERROR) << "Invalid shard '" << cmd_shard->getValue() << "', expected i/N with i<N";
+            return EXIT_FAILURE;
+        }
+        selection.Shard = shard;
+        selection.Shards = shards;
+    }
+
     // override the setup name from cmd line
     if(cmd_setup->isSet()) {
         const auto& setupname = cmd_setup->getValue();
@@ -195,6 +248,20 @@ int main(int argc, char** argv) {
     }
 
 
+    if(cmd_timing->isSet() || cmd_timing_trace->isSet()) {
+        StageTimer::Enabled = true;
+        StageTimer::TraceFile = cmd_timing_trace->getValue();
+    }
+
+    if(cmd_u_scalersonly->isSet()) {
+        UnpackerAcqu::ScalersOnly = true;
+    }
+
+    if(cmd_u_prefilterCBEsum->isSet()) {
+        Reconstruct::PrefilterCBEnergySum = cmd_u_prefilterCBEsum->getValue();
+        LOG(INFO) << "Prefilter events with CBEnergySum < " << Reconstruct::PrefilterCBEnergySum << " MeV";
+    }
+
     // now we can try to open the files with an unpacker
     std::unique_ptr<Unpacker::Module> unpacker = nullptr;
     for(const auto& inputfile : cmd_input->getValue()) {
@@ -228,12 +295,18 @@ int main(int argc, char** argv) {
     list< unique_ptr<analysis::input::DataReader> > readers;
 
     // turn the unpacker into a input::DataReader
-    readers.push_back(std_ext::make_unique<analysis::input::AntReader>(
-                          rootfiles,
-                          move(unpacker),
-                          cmd_u_disablerecon->isSet() ? nullptr : std_ext::make_unique<Reconstruct>()
-                          )
-                      );
+    try {
+        readers.push_back(std_ext::make_unique<analysis::input::AntReader>(
+                              rootfiles,
+                              move(unpacker),
+                              cmd_u_disablerecon->isSet() ? nullptr : std_ext::make_unique<Reconstruct>()
+                              )
+                          );
+    }
+    catch(const analysis::input::DataReader::Exception& e) {
+        LOG(ERROR) << e.what();
+        return EXIT_FAILURE;
+    }
     readers.push_back(std_ext::make_unique<analysis::input::PlutoReader>(rootfiles));
     readers.push_back(std_ext::make_unique<analysis::input::GoatReader>(rootfiles));
 
@@ -283,6 +356,24 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
+    // select output profiles before any output file is created
+    if(cmd_outputProfile->isSet())
+        OutputProfile::Select(cmd_outputProfile->getValue());
+    for(const auto& opt : cmd_outputTreeProfiles->getValue()) {
+        const auto pos = opt.find('=');
+        if(pos == string::npos) {
+            LOG(ERROR) << "Output tree profile '" << opt << "' is not of the form treename=profile";
+            return EXIT_FAILURE;
+        }
+        try {
+            OutputProfile::SelectForTree(opt.substr(0, pos), opt.substr(pos+1));
+        }
+        catch(const OutputProfile::Exception& e) {
+            LOG(ERROR) << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+
     // the real output file, create it here to get all
     // further ROOT objects into this output file
     unique_ptr<WrapTFileOutput> masterFile;
@@ -392,7 +483,7 @@ int main(int argc, char** argv) {
         else
         {
             if(auto setup = ExpConfig::Setup::GetLastFound()) {
-                particleID = std_ext::make_unique<analysis::utils::CBTAPSBasicParticleID>
+                particleID = std_ext::make_unique<analysis::utils::CBTAPSCompiledParticleID>
                              (setup->GetPIDCutsDirectory());
             } else {
                 LOG(WARNING) << "No Setup found while loading ParticleID cuts.";
@@ -404,6 +495,28 @@ int main(int argc, char** argv) {
         LOG(INFO) << "ParticleID disabled by command line";
     }
 
+    if(cmd_p_uncertaintyLUT->isSet()) {
+        analysis::utils::UncertaintyModels::Interpolated::LookupTableBins = cmd_p_uncertaintyLUT->getValue();
+    }
+
+    if(cmd_p_saveEventList->isSet()) {
+        analysis::PhysicsManager::SaveEventLists = true;
+    }
+
+    if(cmd_p_deferDecode->isSet()) {
+        TEventData::DeferredSections = TEventData::Sections_t(TEventData::Section_t::DetectorReadHits)
+                                       | TEventData::Section_t::SlowControls
+                                       | TEventData::Section_t::UnpackerMessages;
+    }
+
+    if(cmd_p_asyncSave->isSet()) {
+        analysis::PhysicsManager::AsyncSaveEvents = true;
+    }
+
+    if(cmd_p_saveCalibrationCache->isSet()) {
+        analysis::PhysicsManager::SaveCalibrationCache = true;
+    }
+
     // create some variables for running
     long long maxevents = cmd_maxevents->isSet()
             ? cmd_maxevents->getValue().back()
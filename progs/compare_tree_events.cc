@@ -1,27 +1,223 @@
+/**
+  * @file compare_tree_events.cc
+  * @brief Compare the treeEvents of two files event by event, for example to validate
+  *        that an optimised unpacker or reconstruction still produces identical output.
+  *
+  *        Events are aligned by their TID, both trees must be sorted by TID as written by Ant.
+  *        The entries of the first tree are split into --jobs shards, which are compared
+  *        by forked worker processes, as ROOT I/O cannot be shared between threads.
+  *        Exits with failure if any difference was found.
+  */
+
 #include "base/CmdLine.h"
 #include "base/Logger.h"
-
 #include "base/WrapTFile.h"
+#include "base/WrapTTree.h"
+#include "base/std_ext/string.h"
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
 
-#include "TTree.h"
-#include "TRint.h"
-#include "TH1D.h"
-#include "TH2D.h"
+#include "analysis/input/event_t.h"
+#include "analysis/utils/EventDiff.h"
 
+#include "base/cereal/cereal.hpp"
+#include "base/cereal/types/string.hpp"
+#include "base/cereal/types/vector.hpp"
+#include "base/cereal/types/map.hpp"
+#include "base/cereal/archives/binary.hpp"
 
-#include "analysis/plot/HistogramFactory.h"
-#include "analysis/plot/root_draw.h"
+#include "TTree.h"
+
+#include <cerrno>
+#include <sstream>
+#include <csignal>
 
-#include <limits>
+#include <unistd.h>
+#include <sys/wait.h>
 
 using namespace ant;
 using namespace std;
 using namespace ant::analysis;
-volatile bool interrupt = false;
+using EventDiff = ant::analysis::utils::EventDiff;
+
+static volatile bool interrupt = false;
+
+struct EventTree_t : WrapTTree {
+    ADD_BRANCH_T(TEvent, data)
+};
+
+TID get_id(const input::event_t& event) {
+    return event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
+}
+
+/**
+ * @brief The input_t struct opens the treeEvents of one file
+ * @note not movable, as the branches are linked to its members
+ */
+struct input_t {
+    const string Filename;
+    WrapTFileInput File;
+    EventTree_t Tree;
+    Long64_t Entries = 0;
+
+    explicit input_t(const string& filename) :
+        Filename(filename), File(filename)
+    {
+        TTree* tree = nullptr;
+        if(!File.GetObject("treeEvents", tree))
+            throw EventDiff::Exception("Cannot find treeEvents in "+filename);
+        Tree.LinkBranches(tree);
+        Entries = tree->GetEntries();
+    }
 
+    input_t(const input_t&) = delete;
+    input_t& operator=(const input_t&) = delete;
+
+    input::event_t Get(Long64_t entry) {
+        Tree.Tree->GetEntry(entry);
+        return input::event_t{move(Tree.data())};
+    }
+
+    /**
+     * @brief LowerBound finds the first entry with a TID not less than the given one
+     */
+    Long64_t LowerBound(const TID& id) {
+        Long64_t lo = 0;
+        Long64_t hi = Entries;
+        while(lo < hi) {
+            const auto mid = lo + (hi-lo)/2;
+            if(get_id(Get(mid)) < id)
+                lo = mid+1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+};
+
+/**
+ * @brief compare_shard compares the entries [begin1, end1) of the first tree
+ *        with the events of the second tree in the same TID range
+ */
+EventDiff::Summary_t compare_shard(const string& filename1, const string& filename2,
+                                   const EventDiff::Options_t& options,
+                                   Long64_t begin1, Long64_t end1)
+{
+    input_t in1(filename1);
+    input_t in2(filename2);
+
+    // the shard boundaries in the second tree are given by the TIDs at the boundaries in the first
+    const Long64_t begin2 = begin1 > 0 ? in2.LowerBound(get_id(in1.Get(begin1))) : 0;
+    const Long64_t end2 = end1 < in1.Entries ? in2.LowerBound(get_id(in1.Get(end1))) : in2.Entries;
+
+    EventDiff diff(options);
+
+    struct reader_t {
+        input_t& Input;
+        Long64_t Entry;
+        const Long64_t End;
+        input::event_t Event;
+        TID ID;
+        bool Valid = false;
+        const Long64_t Begin;
+
+        reader_t(input_t& input, Long64_t begin, Long64_t end) :
+            Input(input), Entry(begin), End(end), Begin(begin) {}
+
+        void Next() {
+            Valid = false;
+            if(Entry >= End)
+                return;
+            Event = Input.Get(Entry);
+            const auto id = get_id(Event);
+            if(Entry > Begin && id < ID)
+                throw EventDiff::Exception(std_ext::formatter()
+                                           << "treeEvents in " << Input.Filename
+                                           << " not sorted by TID at entry " << Entry);
+            ID = id;
+            Valid = true;
+            Entry++;
+        }
+    };
+
+    reader_t r1(in1, begin1, end1);
+    reader_t r2(in2, begin2, end2);
+    r1.Next();
+    r2.Next();
+
+    while((r1.Valid || r2.Valid) && !interrupt) {
+        if(r1.Valid && r2.Valid && r1.ID == r2.ID) {
+            diff.Compare(r1.Event, r2.Event);
+            r1.Next();
+            r2.Next();
+        }
+        else if(r1.Valid && (!r2.Valid || r1.ID < r2.ID)) {
+            diff.AddOnlyFirst(r1.ID);
+            r1.Next();
+        }
+        else {
+            diff.AddOnlySecond(r2.ID);
+            r2.Next();
+        }
+    }
+
+    return diff.GetSummary();
+}
+
+string serialize(const EventDiff::Summary_t& summary) {
+    stringstream ss;
+    {
+        cereal::BinaryOutputArchive ar(ss);
+        ar(summary);
+    }
+    return ss.str();
+}
+
+EventDiff::Summary_t deserialize(const string& str) {
+    stringstream ss(str);
+    cereal::BinaryInputArchive ar(ss);
+    EventDiff::Summary_t summary;
+    ar(summary);
+    return summary;
+}
+
+struct worker_t {
+    pid_t Pid;
+    int   Fd;
+    string Result;
+};
+
+bool write_all(int fd, const string& data) {
+    size_t written = 0;
+    while(written < data.size()) {
+        const auto n = write(fd, data.data()+written, data.size()-written);
+        if(n<0) {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        written += size_t(n);
+    }
+    return true;
+}
+
+string read_all(int fd) {
+    string data;
+    char buf[1 << 16];
+    while(true) {
+        const auto n = read(fd, buf, sizeof(buf));
+        if(n<0) {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+        if(n == 0)
+            break;
+        data.append(buf, size_t(n));
+    }
+    return data;
+}
 
 int main( int argc, char** argv )
 {
@@ -36,72 +232,120 @@ int main( int argc, char** argv )
 
     auto cmd_input1 = cmd.add<TCLAP::ValueArg<string>>("","tree1","treeEvents 1",true,"","rootfile");
     auto cmd_input2 = cmd.add<TCLAP::ValueArg<string>>("","tree2","treeEvents 2",true,"","rootfile");
-    auto cmd_maxevents = cmd.add<TCLAP::MultiArg<int>>("m","maxevents","Process only max events",false,"maxevents");
-
+    auto cmd_maxevents = cmd.add<TCLAP::MultiArg<int>>("m","maxevents","Process only max events of first tree",false,"maxevents");
+    auto cmd_abstol = cmd.add<TCLAP::ValueArg<double>>("","abs-tol","Absolute tolerance for floating point values",false,0.0,"tolerance");
+    auto cmd_reltol = cmd.add<TCLAP::ValueArg<double>>("","rel-tol","Relative tolerance for floating point values",false,0.0,"tolerance");
+    auto cmd_examples = cmd.add<TCLAP::ValueArg<unsigned>>("","examples","Number of differing events listed per field",false,5,"n");
+    auto cmd_jobs = cmd.add<TCLAP::ValueArg<unsigned>>("j","jobs","Number of worker processes, defaults to number of CPUs",false,0,"n");
 
     cmd.parse(argc, argv);
 
-    WrapTFileInput input1(cmd_input1->getValue());
-    WrapTFileInput input2(cmd_input2->getValue());
-
-    TTree* tree1;
-    if(!input1.GetObject("treeEvents", tree1)) {
-        LOG(ERROR) << "Cannot find treeEvents in " << cmd_input1->getValue();
-        exit(EXIT_FAILURE);
+    EventDiff::Options_t options;
+    options.AbsTolerance = cmd_abstol->getValue();
+    options.RelTolerance = cmd_reltol->getValue();
+    options.MaxExamples  = cmd_examples->getValue();
+
+    const auto& filename1 = cmd_input1->getValue();
+    const auto& filename2 = cmd_input2->getValue();
+
+    Long64_t entries1 = 0;
+    try {
+        input_t in1(filename1);
+        input_t in2(filename2);
+        LOG(INFO) << "First treeEvent Entries " << in1.Entries;
+        LOG(INFO) << "Second treeEvent Entries " << in2.Entries;
+        entries1 = in1.Entries;
     }
-    LOG(INFO) << "First treeEvent Entries " << tree1->GetEntries();
-
-    TTree* tree2;
-    if(!input2.GetObject("treeEvents", tree2)) {
-        LOG(ERROR) << "Cannot find treeEvents in " << cmd_input2->getValue();
-        exit(EXIT_FAILURE);
+    catch(const exception& e) {
+        LOG(ERROR) << e.what();
+        return EXIT_FAILURE;
     }
-    LOG(INFO) << "Second treeEvent Entries " << tree2->GetEntries();
 
+    if(cmd_maxevents->isSet())
+        entries1 = min<Long64_t>(entries1, cmd_maxevents->getValue().back());
 
-    TEvent* event1 = new TEvent();
-    TEvent* event2 = new TEvent();
+    unsigned jobs = cmd_jobs->getValue();
+    if(jobs == 0)
+        jobs = max(1l, sysconf(_SC_NPROCESSORS_ONLN));
+    // shards should not be too small, each one needs to search its start in the second tree
+    jobs = unsigned(max<Long64_t>(1, min<Long64_t>(jobs, entries1/1000)));
 
-    tree1->SetBranchAddress("data",addressof(event1));
-    tree2->SetBranchAddress("data",addressof(event2));
-
-    long long entry1 = 0;
-    long long entry2 = 0;
-
-    long long maxevents = cmd_maxevents->isSet()
-            ? cmd_maxevents->getValue().back()
-            :  numeric_limits<long long>::max();
-    long long nEvents = 0;
-
-
-    while(entry1 < tree1->GetEntries() && entry2 < tree2->GetEntries()) {
-
-        if(interrupt)
-            break;
+    auto shard_begin = [entries1, jobs] (unsigned shard) {
+        return entries1*shard/jobs;
+    };
 
-        tree1->GetEntry(entry1);
-        tree2->GetEntry(entry2);
+    EventDiff::Summary_t summary;
 
-        const TEventData& recon1 = event1->Reconstructed();
-        const TEventData& recon2 = event2->Reconstructed();
-
-
-        if(recon1.ID != recon2.ID) {
-            LOG(INFO) << "ID mismatch ID1=" << recon1.ID << " ID2=" << recon2.ID;
-            break;
+    if(jobs == 1) {
+        try {
+            summary = compare_shard(filename1, filename2, options, 0, entries1);
         }
-
-        if(recon1.Trigger.DAQEventID != recon2.Trigger.DAQEventID) {
-            LOG(INFO) << "DAQEventID mismatch ID1=" << recon1.Trigger.DAQEventID << " ID2=" << recon2.Trigger.DAQEventID;
-            break;
+        catch(const exception& e) {
+            LOG(ERROR) << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+    else {
+        LOG(INFO) << "Comparing " << entries1 << " entries in " << jobs << " worker processes";
+
+        vector<worker_t> workers;
+        for(unsigned shard=0;shard<jobs;shard++) {
+            int fds[2];
+            if(pipe(fds) != 0) {
+                LOG(ERROR) << "Could not create pipe";
+                return EXIT_FAILURE;
+            }
+            const pid_t pid = fork();
+            if(pid < 0) {
+                LOG(ERROR) << "Could not fork worker";
+                return EXIT_FAILURE;
+            }
+            if(pid == 0) {
+                close(fds[0]);
+                int status = EXIT_SUCCESS;
+                try {
+                    const auto result = compare_shard(filename1, filename2, options,
+                                                      shard_begin(shard), shard_begin(shard+1));
+                    if(!write_all(fds[1], serialize(result)))
+                        status = EXIT_FAILURE;
+                }
+                catch(const exception& e) {
+                    LOG(ERROR) << "Shard " << shard << ": " << e.what();
+                    status = EXIT_FAILURE;
+                }
+                close(fds[1]);
+                // skip ROOT's cleanup of the inherited state
+                _exit(status);
+            }
+            close(fds[1]);
+            workers.push_back({pid, fds[0], {}});
         }
 
-        nEvents++;
-        if(nEvents==maxevents)
-            break;
-        entry1++;
-        entry2++;
+        // the workers block on writing until their pipe is read,
+        // so read them in order and merge the summaries in file order
+        bool failed = false;
+        for(unsigned shard=0;shard<workers.size();shard++) {
+            auto& worker = workers[shard];
+            worker.Result = read_all(worker.Fd);
+            close(worker.Fd);
+            int status = 0;
+            waitpid(worker.Pid, addressof(status), 0);
+            if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS || worker.Result.empty()) {
+                LOG(ERROR) << "Worker for shard " << shard << " failed";
+                failed = true;
+                continue;
+            }
+            summary.Merge(deserialize(worker.Result), options.MaxExamples);
+        }
+        if(failed)
+            return EXIT_FAILURE;
     }
 
-    LOG(INFO) << "Compared " << nEvents << " events";
-}
\ No newline at end of file
+    cout << summary;
+
+    if(interrupt)
+        LOG(WARNING) << "Interrupted, comparison is incomplete";
+
+    LOG(INFO) << "Compared " << summary.Compared << " events";
+    return summary.Identical() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
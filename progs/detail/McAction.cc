@@ -0,0 +1,100 @@
+#include "McAction.h"
+
+#include "base/Logger.h"
+#include "base/std_ext/string.h"
+
+#include "TChain.h"
+#include "TRandom.h"
+
+#include <cstdio>
+#include <csignal>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace ant;
+
+bool McAction::RunParallel(unsigned nJobs, unsigned seed, const string& mergedfile)
+{
+    if(nJobs == 0)
+        nJobs = 1;
+
+    // part files are named after the merged file
+    string stem = mergedfile;
+    if(std_ext::string_ends_with(stem, ".root"))
+        stem = stem.substr(0, stem.size()-5);
+
+    vector<string> partfiles;
+    vector<pid_t> pids;
+
+    // stop and reap the workers started so far, their part files are incomplete
+    auto abort_jobs = [&pids, &partfiles] () {
+        for(auto pid : pids)
+            kill(pid, SIGTERM);
+        for(auto pid : pids)
+            waitpid(pid, nullptr, 0);
+        for(const auto& partfile : partfiles)
+            std::remove(partfile.c_str());
+    };
+
+    const unsigned nEventsTotal = nEvents;
+    for(unsigned job=0;job<nJobs;job++) {
+        // distribute the remainder over the first jobs
+        const unsigned nEventsJob = nEventsTotal/nJobs + (job < nEventsTotal % nJobs ? 1 : 0);
+        const string partfile = std_ext::formatter() << stem << "_part" << job << ".root";
+        partfiles.emplace_back(partfile);
+
+        const pid_t pid = fork();
+        if(pid < 0) {
+            LOG(ERROR) << "Could not fork worker process for job " << job;
+            abort_jobs();
+            return false;
+        }
+        if(pid == 0) {
+            // in child process, every job has its own independent stream
+            gRandom->SetSeed(seed+1+job);
+            nEvents = nEventsJob;
+            outfile = partfile;
+            Run();
+            // skip the destructors of the parent's objects
+            _exit(EXIT_SUCCESS);
+        }
+        VLOG(1) << "Started job " << job << " (pid=" << pid << ") with "
+                << nEventsJob << " events, seed=" << seed+1+job;
+        pids.push_back(pid);
+    }
+
+    bool success = true;
+    for(unsigned job=0;job<pids.size();job++) {
+        int status = 0;
+        waitpid(pids[job], addressof(status), 0);
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            LOG(ERROR) << "Job " << job << " failed";
+            success = false;
+        }
+    }
+    if(!success) {
+        // all workers are reaped already
+        pids.clear();
+        abort_jobs();
+        return false;
+    }
+
+    LOG(INFO) << "All " << nJobs << " jobs finished, merging into " << mergedfile;
+
+    // keep the order of the jobs, baskets are copied without recompression
+    TChain chain("data");
+    for(const auto& partfile : partfiles)
+        chain.Add(partfile.c_str());
+    if(chain.Merge(mergedfile.c_str(), "fast") <= 0) {
+        LOG(ERROR) << "Merging part files failed, keeping them";
+        return false;
+    }
+
+    for(const auto& partfile : partfiles)
+        std::remove(partfile.c_str());
+
+    return true;
+}
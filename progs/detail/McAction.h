@@ -9,4 +9,16 @@ struct McAction {
     double   Emax;
     virtual void Run() const =0;
     virtual ~McAction() = default;
+
+    /**
+     * @brief RunParallel splits nEvents into nJobs streams, each generated by Run()
+     * in a forked process with gRandom seeded deterministically by seed+1+job.
+     * The "data" trees of the part files are then merged in job order into mergedfile,
+     * such that a subsequent PlutoTID::AddTID gives consistent TIDs for the whole sample.
+     * @param nJobs number of worker processes
+     * @param seed base seed, the sample is reproducible for the same seed and nJobs
+     * @param mergedfile final output file, must end in ".root"
+     * @return true if all workers succeeded and merging worked
+     */
+    bool RunParallel(unsigned nJobs, unsigned seed, const std::string& mergedfile);
 };
@@ -1,15 +1,24 @@
 #include "AntReader.h"
+#include "EventList.h"
+#include "CalibrationCache.h"
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
 
 #include "base/Logger.h"
 #include "base/WrapTTree.h"
+#include "base/StageTimer.h"
+#include "base/std_ext/memory.h"
+#include "base/std_ext/string.h"
 
 #include "TTree.h"
+#include "TFile.h"
 
 #include <memory>
 #include <stdexcept>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
 
 using namespace std;
 using namespace ant;
@@ -37,71 +46,330 @@ struct UnpackerReader : AntReaderInternal {
         return unpacker->PercentDone();
     }
     virtual event_t NextEvent() override {
+        StageTimer::Scope t(timer);
         return event_t{unpacker->NextEvent()};
     }
 private:
     unique_ptr<Unpacker::Module> unpacker;
+    const StageTimer::id_t timer = StageTimer::Register("Unpacker");
 }; // UnpackerReader
 
 
+struct EventTree_t : WrapTTree {
+    ADD_BRANCH_T(TEvent, data)
+};
+
+shared_ptr<const string> GetSourceFile(const EventTree_t& tree) {
+    // prefer absolute paths, event lists might be read from elsewhere
+    const auto file = tree.Tree->GetCurrentFile();
+    if(!file)
+        return nullptr;
+    string filename = file->GetName();
+    if(char* path = realpath(filename.c_str(), nullptr)) {
+        filename = path;
+        free(path);
+    }
+    return make_shared<const string>(filename);
+}
+
 struct TreeReader : AntReaderInternal {
-    TreeReader(const std::shared_ptr<WrapTFileInput>& rootfiles)
+    TreeReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
+               const AntReader::EntrySelection_t& selection)
     {
-        if(!rootfiles->GetObject("treeEvents", tree.Tree))
+        for(TTree* t : rootfiles->GetObjects<TTree>("treeEvents")) {
+            if(t->GetEntries() == 0)
+                continue;
+            inputs.emplace_back(t);
+        }
+        if(inputs.empty())
             return;
 
-        VLOG(5) << "Found Ant Events Tree";
-        tree.LinkBranches();
+        if(inputs.size()>1) {
+            // the slowcontrol handling expects events in order,
+            // so read the files sorted by the TID ranges
+            auto get_id = [this] (Long64_t entry) {
+                tree.Tree->GetEntry(entry);
+                const event_t event{move(tree.data())};
+                return event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
+            };
+            for(auto& input : inputs) {
+                tree.LinkBranches(input.Tree);
+                input.FirstID = get_id(0);
+                input.LastID = get_id(input.Entries-1);
+            }
+            stable_sort(inputs.begin(), inputs.end(), [] (const input_t& a, const input_t& b) {
+                return a.FirstID < b.FirstID;
+            });
+            for(auto it = next(inputs.begin()); it != inputs.end(); ++it) {
+                VLOG(5) << "treeEvents in " << it->Tree->GetCurrentFile()->GetName()
+                        << " from " << it->FirstID << " to " << it->LastID;
+                if(it->FirstID < prev(it)->LastID)
+                    LOG(WARNING) << "TID ranges of treeEvents in " << prev(it)->Tree->GetCurrentFile()->GetName()
+                                 << " and " << it->Tree->GetCurrentFile()->GetName() << " overlap";
+            }
+        }
+
+        // build global entry index
+        Long64_t total = 0;
+        for(auto& input : inputs) {
+            input.Offset = total;
+            total += input.Entries;
+        }
+
+        begin_entry = std::max(selection.Begin, 0ll);
+        end_entry = std::min(selection.End, total);
+        if(end_entry < begin_entry)
+            end_entry = begin_entry;
+        if(selection.Shards>1) {
+            const auto n = end_entry - begin_entry;
+            const auto shard_begin = begin_entry + n*selection.Shard/selection.Shards;
+            const auto shard_end = begin_entry + n*(selection.Shard+1)/selection.Shards;
+            begin_entry = shard_begin;
+            end_entry = shard_end;
+        }
+        current_entry = begin_entry;
+
+        if(inputs.size()>1 || begin_entry>0 || end_entry<total)
+            LOG(INFO) << "Reading treeEvents entries " << begin_entry << " to " << end_entry
+                      << " of " << total << " in " << inputs.size() << " files";
+
+        // link the file containing the first entry
+        while(current_input+1<inputs.size() && inputs[current_input+1].Offset <= current_entry)
+            current_input++;
+        LinkInput();
     }
 
     virtual ~TreeReader() = default;
 
     virtual double PercentDone() const override {
-        if(tree)
-            return double(current_entry)/double(tree.Tree->GetEntries());
-        return numeric_limits<double>::quiet_NaN();
+        if(inputs.empty())
+            return numeric_limits<double>::quiet_NaN();
+        if(end_entry == begin_entry)
+            return 1.0;
+        return double(current_entry-begin_entry)/double(end_entry-begin_entry);
     }
 
     virtual event_t NextEvent() override {
-        if(!tree)
+        if(inputs.empty())
             return {};
 
-        if(current_entry==tree.Tree->GetEntries())
+        if(current_entry>=end_entry)
             return {};
 
-        tree.Tree->GetEntry(current_entry);
+        auto input = addressof(inputs[current_input]);
+        if(current_entry >= input->Offset + input->Entries) {
+            current_input++;
+            LinkInput();
+            input = addressof(inputs[current_input]);
+        }
+
+        const auto entry = current_entry - input->Offset;
+        tree.Tree->GetEntry(entry);
+        event_t event{move(tree.data())};
+        event.SourceFile = input->SourceFile;
+        event.SourceEntry = entry;
         current_entry++;
-        return event_t{move(tree.data())};
+        return event;
     }
 
 private:
-    Long64_t current_entry = 0;
-    struct EventTree_t : WrapTTree {
-        ADD_BRANCH_T(TEvent, data)
+    struct input_t {
+        explicit input_t(TTree* tree) : Tree(tree), Entries(tree->GetEntries()) {}
+        TTree* Tree;
+        Long64_t Entries;
+        Long64_t Offset = 0;
+        TID FirstID;
+        TID LastID;
+        shared_ptr<const string> SourceFile;
     };
+
+    vector<input_t> inputs;
+    size_t current_input = 0;
+    Long64_t begin_entry = 0;
+    Long64_t end_entry = 0;
+    Long64_t current_entry = 0;
     EventTree_t tree;
+
+    void LinkInput() {
+        auto& input = inputs[current_input];
+        tree.LinkBranches(input.Tree);
+        if(!input.SourceFile)
+            input.SourceFile = GetSourceFile(tree);
+        VLOG(5) << "Reading treeEvents from " << *input.SourceFile;
+    }
 }; // TreeReader
 
+struct EventListReader : AntReaderInternal {
+    EventListReader(const std::shared_ptr<WrapTFileInput>& rootfiles)
+    {
+        if(!rootfiles->GetObject(EventList_t::TreeName, list.Tree))
+            return;
+
+        list.LinkBranches();
+        for(auto& filename : list.GetSources())
+            sources.emplace_back(make_shared<const string>(filename));
+        sourcetrees.resize(sources.size());
+
+        LOG(INFO) << "Reading " << list.Tree->GetEntries() << " events from event list with "
+                  << sources.size() << " source files";
+    }
+
+    virtual ~EventListReader() = default;
+
+    virtual double PercentDone() const override {
+        if(list)
+            return double(current_entry)/double(list.Tree->GetEntries());
+        return numeric_limits<double>::quiet_NaN();
+    }
+
+    virtual event_t NextEvent() override {
+        if(!list)
+            return {};
+
+        if(current_entry==list.Tree->GetEntries())
+            return {};
+
+        list.Tree->GetEntry(current_entry);
+        current_entry++;
+
+        auto& tree = GetSourceTree(list.Source());
+        if(tree.Tree->GetEntry(list.Entry()) <= 0)
+            throw Exception(std_ext::formatter() << "Cannot read entry " << list.Entry()
+                            << " from " << *sources[list.Source()]);
+
+        event_t event{move(tree.data())};
+        // same as SaveEvent, MC-only events are listed by their MCTrue ID
+        const bool matches = event.HasReconstructed() ? event.Reconstructed().ID == list.ID()
+                                                      : event.HasMCTrue() && event.MCTrue().ID == list.ID();
+        if(!matches)
+            throw Exception(std_ext::formatter() << "Event at entry " << list.Entry()
+                            << " in " << *sources[list.Source()]
+                            << " does not match event list ID " << list.ID());
+
+        event.SavedForSlowControls |= list.SavedForSlowControls();
+        event.SourceFile = sources[list.Source()];
+        event.SourceEntry = list.Entry();
+        return event;
+    }
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+private:
+    Long64_t current_entry = 0;
+    EventList_t list;
+
+    struct sourcetree_t {
+        std::unique_ptr<WrapTFileInput> file;
+        EventTree_t tree;
+    };
+
+    vector<shared_ptr<const string>> sources;
+    vector<unique_ptr<sourcetree_t>> sourcetrees;
+
+    EventTree_t& GetSourceTree(unsigned index) {
+        if(index >= sourcetrees.size())
+            throw Exception(std_ext::formatter() << "Invalid source index " << index << " in event list");
+        auto& sourcetree = sourcetrees[index];
+        if(!sourcetree) {
+            sourcetree = std_ext::make_unique<sourcetree_t>();
+            sourcetree->file = std_ext::make_unique<WrapTFileInput>(*sources[index]);
+            if(!sourcetree->file->GetObject("treeEvents", sourcetree->tree.Tree))
+                throw Exception("No treeEvents found in event list source " + *sources[index]);
+            sourcetree->tree.LinkBranches();
+            VLOG(5) << "Opened event list source " << *sources[index];
+        }
+        return sourcetree->tree;
+    }
+}; // EventListReader
+
+struct CalibrationCacheReader : AntReaderInternal {
+    CalibrationCacheReader(const std::shared_ptr<WrapTFileInput>& rootfiles)
+    {
+        if(!rootfiles->GetObject(CalibrationCache_t::TreeName, cache.Tree))
+            return;
+
+        cache.LinkBranches();
+        LOG(INFO) << "Reading " << cache.Tree->GetEntries() << " events from calibration cache";
+    }
+
+    virtual ~CalibrationCacheReader() = default;
+
+    virtual double PercentDone() const override {
+        if(cache)
+            return double(current_entry)/double(cache.Tree->GetEntries());
+        return numeric_limits<double>::quiet_NaN();
+    }
+
+    virtual event_t NextEvent() override {
+        if(!cache)
+            return {};
+
+        if(current_entry==cache.Tree->GetEntries())
+            return {};
+
+        cache.Tree->GetEntry(current_entry);
+        current_entry++;
+
+        // the uncalibrated hits are then reconstructed again by AntReader
+        event_t event;
+        event.MakeReconstructed(cache.ID());
+        cache.Get(event.Reconstructed());
+        return event;
+    }
+
+private:
+    Long64_t current_entry = 0;
+    CalibrationCache_t cache;
+}; // CalibrationCacheReader
+
 }}}} // namespace ant::analysis::input::detail
 
 
+AntReader::EntrySelection_t AntReader::EntrySelection;
+
 AntReader::AntReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
         unique_ptr<Unpacker::Module> unpacker,
         std::unique_ptr<Reconstruct_traits> reconstruct_
         ) :
     reconstruct(move(reconstruct_))
 {
+    // the entry selection only works for plain treeEvents,
+    // silently reading everything instead would duplicate the output of all shards
+    auto check_selection = [] (const string& input) {
+        if(EntrySelection.IsRestricted())
+            throw Exception("Entry range and shards can only be applied to treeEvents, but reading from "+input);
+    };
+
     // prefer unpacker
     if(unpacker) {
+        check_selection("unpacker");
         reader = std_ext::make_unique<detail::UnpackerReader>(move(unpacker));
         if(!reconstruct)
             LOG(WARNING) << "Reconstruct disabled although reading from unpacker. Producing DetectorReadHits only.";
     }
     else {
-        // try root files
-        auto treereader = std_ext::make_unique<detail::TreeReader>(rootfiles);
+        // try root files, prefer calibration caches and event lists over plain treeEvents
+        auto cachereader = std_ext::make_unique<detail::CalibrationCacheReader>(rootfiles);
+        if(isfinite(cachereader->PercentDone())) {
+            check_selection("calibration cache");
+            reader = move(cachereader);
+            if(!reconstruct)
+                LOG(WARNING) << "Reconstruct disabled although reading from calibration cache. Producing DetectorReadHits only.";
+            return;
+        }
+        auto listreader = std_ext::make_unique<detail::EventListReader>(rootfiles);
+        if(isfinite(listreader->PercentDone())) {
+            check_selection("event list");
+            reader = move(listreader);
+            return;
+        }
+        auto treereader = std_ext::make_unique<detail::TreeReader>(rootfiles, EntrySelection);
         if(isfinite(treereader->PercentDone()))
             reader = move(treereader);
+        else
+            check_selection("input without treeEvents");
     }
 
 }
@@ -130,10 +398,16 @@ bool AntReader::ReadNextEvent(event_t& event)
     if(nextevent) {
         if(reconstruct) {
             TEventData& recon = nextevent.Reconstructed();
+            recon.Decode(TEventData::Section_t::Candidates);
             /// \todo improve check if TEvent was run through reconstructed
             /// you may also introduce some flag to force application?
-            if(recon.Clusters.empty())
+            if(recon.Clusters.empty()) {
+                static const auto timer = StageTimer::Register("Reconstruct");
+                StageTimer::Scope t(timer);
+                recon.Decode();
                 reconstruct->DoReconstruct(recon);
+                nextevent.prefiltered = reconstruct->Prefiltered();
+            }
         }
 
         // pay attention that Geant unpacker might also set MCTrue branch partly
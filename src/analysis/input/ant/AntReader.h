@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <limits>
 
 namespace ant {
 namespace analysis {
@@ -36,6 +37,27 @@ public:
     virtual bool ReadNextEvent(event_t& event) override;
 
     double PercentDone() const override;
+
+    /**
+     * @brief The EntrySelection_t struct restricts reading treeEvents to a range of entries
+     *
+     * Entries are counted over all given files, which are sorted by their first event's TID.
+     * The range [Begin,End) is further split into Shards parts of equal size, and only
+     * the part with index Shard is read. Used to process many files in several independent jobs.
+     * The constructor throws an Exception if a restricting selection is set, but the AntReader
+     * does not read treeEvents (unpacker, calibration caches, event lists).
+     */
+    struct EntrySelection_t {
+        long long Begin = 0;
+        long long End = std::numeric_limits<long long>::max();
+        unsigned Shard = 0;
+        unsigned Shards = 1;
+
+        bool IsRestricted() const {
+            return Begin > 0 || End < std::numeric_limits<long long>::max() || Shards > 1;
+        }
+    };
+    static EntrySelection_t EntrySelection;
 };
 
 }
@@ -0,0 +1,192 @@
+#include "CalibrationCache.h"
+
+#include "tree/TEventData.h"
+
+#include "base/cereal/cereal.hpp"
+#include "base/cereal/types/string.hpp"
+#include "base/cereal/types/vector.hpp"
+#include "base/cereal/archives/binary.hpp"
+
+#include <sstream>
+#include <cstring>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+const string CalibrationCache_t::TreeName = "treeCalibrationCache";
+
+namespace {
+
+enum flags_t : uint8_t {
+    NewTypes = 1 << 0, // detector and channel type follow
+    HasRaw   = 1 << 1, // raw data follows, otherwise uncalibrated values
+};
+
+void put_varint(vector<uint8_t>& bytes, uint64_t v) {
+    while(v >= 0x80) {
+        bytes.push_back(uint8_t(v) | 0x80);
+        v >>= 7;
+    }
+    bytes.push_back(uint8_t(v));
+}
+
+struct reader_t {
+    const vector<uint8_t>& bytes;
+    size_t pos = 0;
+
+    explicit reader_t(const vector<uint8_t>& bytes_) : bytes(bytes_) {}
+
+    void check(size_t n) const {
+        if(pos + n > bytes.size())
+            throw CalibrationCache_t::Exception("Calibration cache entry is truncated");
+    }
+    uint8_t get_byte() {
+        check(1);
+        return bytes[pos++];
+    }
+    uint64_t get_varint() {
+        uint64_t v = 0;
+        for(unsigned shift=0;shift<64;shift+=7) {
+            const auto b = get_byte();
+            v |= uint64_t(b & 0x7f) << shift;
+            if(!(b & 0x80))
+                return v;
+        }
+        throw CalibrationCache_t::Exception("Calibration cache entry has invalid varint");
+    }
+};
+
+// zigzag encoding maps small negative differences to small numbers
+uint64_t zigzag(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+int64_t unzigzag(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+}
+
+void CalibrationCache_t::EncodeHits(const vector<TDetectorReadHit>& hits, vector<uint8_t>& bytes)
+{
+    bytes.clear();
+    put_varint(bytes, hits.size());
+
+    bool first = true;
+    Detector_t::Type_t prev_detector = Detector_t::Type_t::Trigger;
+    Channel_t::Type_t  prev_channeltype = Channel_t::Type_t::Timing;
+    int64_t prev_channel = 0;
+
+    for(const TDetectorReadHit& hit : hits) {
+        uint8_t flags = 0;
+        if(first || hit.DetectorType != prev_detector || hit.ChannelType != prev_channeltype) {
+            flags |= NewTypes;
+            prev_detector = hit.DetectorType;
+            prev_channeltype = hit.ChannelType;
+            prev_channel = 0;
+            first = false;
+        }
+        // calibrations rebuild the values from raw data, if present
+        if(!hit.RawData.empty())
+            flags |= HasRaw;
+
+        bytes.push_back(flags);
+        if(flags & NewTypes) {
+            bytes.push_back(static_cast<uint8_t>(hit.DetectorType));
+            bytes.push_back(static_cast<uint8_t>(hit.ChannelType));
+        }
+        put_varint(bytes, zigzag(int64_t(hit.Channel) - prev_channel));
+        prev_channel = hit.Channel;
+
+        if(flags & HasRaw) {
+            put_varint(bytes, hit.RawData.size());
+            bytes.insert(bytes.end(), hit.RawData.begin(), hit.RawData.end());
+        }
+        else {
+            put_varint(bytes, hit.Values.size());
+            for(const auto& value : hit.Values) {
+                const float uncalibrated = value.Uncalibrated;
+                uint8_t buf[sizeof(float)];
+                memcpy(buf, &uncalibrated, sizeof(float));
+                bytes.insert(bytes.end(), begin(buf), end(buf));
+            }
+        }
+    }
+}
+
+void CalibrationCache_t::DecodeHits(const vector<uint8_t>& bytes, vector<TDetectorReadHit>& hits)
+{
+    reader_t r(bytes);
+    const auto nHits = r.get_varint();
+    hits.clear();
+    hits.reserve(nHits);
+
+    LogicalChannel_t element;
+    int64_t prev_channel = 0;
+
+    for(uint64_t i=0;i<nHits;i++) {
+        const auto flags = r.get_byte();
+        if(flags & NewTypes) {
+            element.DetectorType = static_cast<Detector_t::Type_t>(r.get_byte());
+            element.ChannelType  = static_cast<Channel_t::Type_t>(r.get_byte());
+            prev_channel = 0;
+        }
+        else if(i == 0) {
+            throw Exception("Calibration cache entry does not start with hit types");
+        }
+        prev_channel += unzigzag(r.get_varint());
+        element.Channel = static_cast<unsigned>(prev_channel);
+
+        const auto n = r.get_varint();
+        if(flags & HasRaw) {
+            r.check(n);
+            const auto it = bytes.begin() + r.pos;
+            hits.emplace_back(element, vector<uint8_t>(it, it + n));
+            r.pos += n;
+        }
+        else {
+            r.check(n*sizeof(float));
+            hits.emplace_back(element, vector<uint8_t>());
+            auto& values = hits.back().Values;
+            values.reserve(n);
+            for(uint64_t j=0;j<n;j++) {
+                float uncalibrated;
+                memcpy(&uncalibrated, &bytes[r.pos], sizeof(float));
+                r.pos += sizeof(float);
+                values.emplace_back(uncalibrated);
+            }
+        }
+    }
+}
+
+void CalibrationCache_t::Set(const TEventData& eventdata)
+{
+    ID = eventdata.ID;
+    DAQEventID = eventdata.Trigger.DAQEventID;
+    EncodeHits(eventdata.DetectorReadHits, Hits);
+
+    // most events don't have any of those
+    Extra().clear();
+    if(eventdata.SlowControls.empty() &&
+       eventdata.UnpackerMessages.empty() &&
+       eventdata.Trigger.DAQErrors.empty())
+        return;
+
+    stringstream ss;
+    {
+        cereal::BinaryOutputArchive archive(ss);
+        archive(eventdata.SlowControls, eventdata.UnpackerMessages, eventdata.Trigger.DAQErrors);
+    }
+    const auto& str = ss.str();
+    Extra().assign(str.begin(), str.end());
+}
+
+void CalibrationCache_t::Get(TEventData& eventdata) const
+{
+    eventdata.ID = ID;
+    eventdata.Trigger.DAQEventID = DAQEventID;
+    DecodeHits(Hits, eventdata.DetectorReadHits);
+
+    if(Extra().empty())
+        return;
+
+    stringstream ss(string(Extra().begin(), Extra().end()));
+    cereal::BinaryInputArchive archive(ss);
+    archive(eventdata.SlowControls, eventdata.UnpackerMessages, eventdata.Trigger.DAQErrors);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "base/WrapTTree.h"
+#include "tree/TID.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace ant {
+
+struct TEventData;
+struct TDetectorReadHit;
+
+namespace analysis {
+namespace input {
+
+/**
+ * @brief The CalibrationCache_t struct stores the uncalibrated detector hits of each event
+ *
+ * It is written by PhysicsManager in addition to the usual output, and replayed by AntReader
+ * through the reconstruction again. Iterating calibrations then does not need to read
+ * and unpack the raw files again.
+ *
+ * Only what the reconstruction needs is kept: The RawData of each hit (or the uncalibrated
+ * values as float if there is no RawData, as for MC), plus the slowcontrol, unpacker messages
+ * and DAQ errors of the event. The hits are packed into a byte blob, with varint encoded
+ * channel differences and lengths.
+ */
+struct CalibrationCache_t : WrapTTree {
+    ADD_BRANCH_T(TID,                       ID)
+    ADD_BRANCH_T(unsigned,                  DAQEventID)
+    ADD_BRANCH_T(std::vector<std::uint8_t>, Hits)
+    ADD_BRANCH_T(std::vector<std::uint8_t>, Extra)
+
+    static const std::string TreeName;
+
+    /**
+     * @brief Set the branches from the reconstructed event data, calibrations applied to it are ignored
+     */
+    void Set(const TEventData& eventdata);
+
+    /**
+     * @brief Get restores the uncalibrated event data from the current entry
+     */
+    void Get(TEventData& eventdata) const;
+
+    static void EncodeHits(const std::vector<TDetectorReadHit>& hits, std::vector<std::uint8_t>& bytes);
+    static void DecodeHits(const std::vector<std::uint8_t>& bytes, std::vector<TDetectorReadHit>& hits);
+};
+
+}}} // namespace ant::analysis::input
@@ -0,0 +1,41 @@
+#include "EventList.h"
+
+#include "TList.h"
+#include "TObjString.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+const string EventList_t::TreeName = "treeEventList";
+
+unsigned EventList_t::AddSource(const string& filename)
+{
+    auto it = sourceIndices.find(filename);
+    if(it != sourceIndices.end())
+        return it->second;
+
+    if(!Tree)
+        throw Exception("EventList tree not created yet");
+
+    auto userinfo = Tree->GetUserInfo();
+    const auto index = unsigned(userinfo->GetSize());
+    userinfo->Add(new TObjString(filename.c_str()));
+    sourceIndices.emplace(filename, index);
+    return index;
+}
+
+vector<string> EventList_t::GetSources() const
+{
+    vector<string> sources;
+    if(!Tree)
+        return sources;
+    TIter next(Tree->GetUserInfo());
+    while(auto obj = next()) {
+        auto str = dynamic_cast<TObjString*>(obj);
+        if(str == nullptr)
+            throw Exception("Found unexpected object in UserInfo of event list");
+        sources.emplace_back(str->GetString().Data());
+    }
+    return sources;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "base/WrapTTree.h"
+#include "tree/TID.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ant {
+namespace analysis {
+namespace input {
+
+/**
+ * @brief The EventList_t struct is written by PhysicsManager instead of full TEvent copies
+ *
+ * Each entry points to an entry of the treeEvents in one of the source files,
+ * which are stored in the UserInfo of the tree. AntReader replays such lists
+ * by reading the referenced entries directly from the source files.
+ * Replaying and saving a list again refers to the original source files,
+ * so chained skims stay small.
+ */
+struct EventList_t : WrapTTree {
+    ADD_BRANCH_T(unsigned, Source)
+    ADD_BRANCH_T(Long64_t, Entry)
+    ADD_BRANCH_T(TID,      ID)
+    ADD_BRANCH_T(bool,     SavedForSlowControls)
+
+    static const std::string TreeName;
+
+    /**
+     * @brief AddSource registers the filename in the tree's UserInfo if not already present
+     * @param filename the file containing the referenced treeEvents
+     * @return index to be used for the Source branch
+     */
+    unsigned AddSource(const std::string& filename);
+
+    /**
+     * @brief GetSources reads the source filenames from the tree's UserInfo
+     * @return list of filenames, indexed by the Source branch
+     */
+    std::vector<std::string> GetSources() const;
+
+protected:
+    std::map<std::string, unsigned> sourceIndices;
+};
+
+}}} // namespace ant::analysis::input
@@ -2,6 +2,9 @@
 
 #include "tree/TEvent.h"
 
+#include <memory>
+#include <string>
+
 namespace ant {
 namespace analysis {
 namespace input {
@@ -17,6 +20,15 @@ struct event_t : TEvent {
     bool empty_reconstructed = false;
     bool empty_mctrue = false;
 
+    // set if Reconstruct rejected the event before clustering,
+    // such events are not processed by physics classes
+    bool prefiltered = false;
+
+    // position in the treeEvents this event was read from (if any),
+    // used to save event lists instead of full copies
+    std::shared_ptr<const std::string> SourceFile;
+    long long SourceEntry = -1;
+
     bool HasReconstructed() const { return reconstructed!=nullptr; }
     bool HasMCTrue() const { return mctrue!=nullptr; }
 
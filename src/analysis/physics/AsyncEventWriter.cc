@@ -0,0 +1,265 @@
+#include "AsyncEventWriter.h"
+
+#include "tree/TEvent.h"
+
+#include "base/Logger.h"
+#include "base/OutputProfile.h"
+#include "base/std_ext/memory.h"
+#include "base/std_ext/string.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBufferFile.h"
+#include "TDirectory.h"
+
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+namespace {
+
+// each event is framed by its length
+using length_t = uint32_t;
+
+bool write_all(int fd, const char* data, size_t size) {
+    // a crashed writer should make the write fail with EPIPE, not kill us,
+    // so block SIGPIPE meanwhile instead of ignoring it for the whole process
+    sigset_t sigpipe, previous, pending;
+    sigemptyset(addressof(sigpipe));
+    sigaddset(addressof(sigpipe), SIGPIPE);
+    sigpending(addressof(pending));
+    const bool was_pending = sigismember(addressof(pending), SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, addressof(sigpipe), addressof(previous));
+
+    bool broken = false;
+    while(size>0) {
+        const auto n = write(fd, data, size);
+        if(n<0) {
+            if(errno == EINTR)
+                continue;
+            broken = errno == EPIPE;
+            break;
+        }
+        data += n;
+        size -= size_t(n);
+    }
+
+    // consume the SIGPIPE we caused, before it gets delivered on unblocking
+    if(broken && !was_pending) {
+        const timespec nowait{0, 0};
+        while(sigtimedwait(addressof(sigpipe), nullptr, addressof(nowait)) < 0 && errno == EINTR);
+    }
+    pthread_sigmask(SIG_SETMASK, addressof(previous), nullptr);
+    return size == 0;
+}
+
+}
+
+AsyncEventWriter::AsyncEventWriter(const string& outputfilename, int compression, size_t bufferSize) :
+    tmpfilename(std_ext::formatter() << outputfilename << ".treeEvents." << getpid() << ".tmp"),
+    tbuffer(std_ext::make_unique<TBufferFile>(TBuffer::kWrite, 1 << 16))
+{
+    int fds[2];
+    if(pipe(fds) != 0)
+        throw Exception("Cannot create pipe to event writer");
+
+#ifdef F_SETPIPE_SZ
+    // enlarging the pipe fails above /proc/sys/fs/pipe-max-size for unprivileged
+    // processes, so try smaller sizes and use the capacity actually granted
+    for(auto size = bufferSize; size > chunkSize; size /= 2) {
+        if(fcntl(fds[1], F_SETPIPE_SZ, int(size)) >= 0)
+            break;
+    }
+    const auto capacity = fcntl(fds[1], F_GETPIPE_SZ);
+    if(capacity > 0)
+        chunkSize = size_t(capacity);
+#endif
+    // a larger chunk would block the Fill() until the writer has read most of it
+    chunkSize = min(chunkSize, bufferSize);
+
+    writer = fork();
+    if(writer < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw Exception("Cannot fork event writer");
+    }
+    if(writer == 0) {
+        close(fds[1]);
+        const int status = RunWriter(fds[0], tmpfilename, compression);
+        close(fds[0]);
+        // skip any cleanup of the state inherited from the parent
+        _exit(status);
+    }
+
+    close(fds[0]);
+    fd = fds[1];
+    buffer.reserve(chunkSize);
+
+    VLOG(5) << "Started event writer process " << writer << " writing to " << tmpfilename
+            << " in chunks of " << chunkSize << " bytes";
+}
+
+AsyncEventWriter::~AsyncEventWriter()
+{
+    if(writer>0)
+        Abort();
+}
+
+void AsyncEventWriter::Fill(TEvent& event)
+{
+    tbuffer->SetBufferOffset(0);
+    event.Streamer(*tbuffer);
+
+    const length_t length = tbuffer->Length();
+
+    // hand over the chunk before it exceeds the pipe,
+    // single events larger than that are sent on their own
+    if(buffer.size() + sizeof(length) + length > chunkSize)
+        Flush();
+
+    const auto offset = buffer.size();
+    buffer.resize(offset + sizeof(length) + length);
+    memcpy(addressof(buffer[offset]), addressof(length), sizeof(length));
+    memcpy(addressof(buffer[offset+sizeof(length)]), tbuffer->Buffer(), length);
+    nEntries++;
+}
+
+void AsyncEventWriter::Flush()
+{
+    if(buffer.empty())
+        return;
+    if(!write_all(fd, buffer.data(), buffer.size()))
+        throw Exception(std_ext::formatter() << "Event writer process " << writer << " stopped unexpectedly");
+    buffer.clear();
+}
+
+bool AsyncEventWriter::Wait()
+{
+    if(fd>=0) {
+        close(fd);
+        fd = -1;
+    }
+    int status = 0;
+    while(waitpid(writer, addressof(status), 0) < 0) {
+        if(errno != EINTR)
+            break;
+    }
+    writer = -1;
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+TTree* AsyncEventWriter::Finish(TDirectory& target)
+{
+    Flush();
+    if(!Wait()) {
+        unlink(tmpfilename.c_str());
+        throw Exception("Event writer process failed");
+    }
+
+    TTree* copy = nullptr;
+    {
+        TFile tmpfile(tmpfilename.c_str(), "READ");
+        TTree* tree = nullptr;
+        tmpfile.GetObject("treeEvents", tree);
+        if(!tree) {
+            unlink(tmpfilename.c_str());
+            throw Exception("Cannot find treeEvents written by event writer in " + tmpfilename);
+        }
+
+        // copy the compressed baskets, compression settings are the same
+        auto prevDirectory = gDirectory;
+        target.cd();
+        copy = tree->CloneTree(0);
+        if(copy->CopyEntries(tree, -1, "fast") < 0) {
+            LOG(WARNING) << "Fast copy of treeEvents from " << tmpfilename << " failed, recompressing";
+            delete copy;
+            copy = tree->CloneTree(0);
+            copy->CopyEntries(tree);
+        }
+        copy->ResetBranchAddresses();
+        delete tree;
+        prevDirectory->cd();
+    }
+    unlink(tmpfilename.c_str());
+
+    if(copy->GetEntries() != Long64_t(nEntries))
+        throw Exception(std_ext::formatter() << "Event writer wrote " << copy->GetEntries()
+                        << " treeEvents, but " << nEntries << " were filled");
+    return copy;
+}
+
+void AsyncEventWriter::Abort()
+{
+    buffer.clear();
+    Wait();
+    unlink(tmpfilename.c_str());
+}
+
+int AsyncEventWriter::RunWriter(int fd, const string& filename, int compression)
+{
+    try {
+        TFile file(filename.c_str(), "RECREATE", "", compression);
+        if(file.IsZombie())
+            throw Exception("Cannot open " + filename);
+
+        auto tree = new TTree("treeEvents","TEvent data");
+        TEvent event;
+        TEvent* eventPtr = addressof(event);
+        tree->Branch("data", addressof(eventPtr));
+        // the copy in Finish() keeps the settings of the branch
+        OutputProfile::Apply(*tree);
+
+        vector<char> data;
+        size_t begin = 0;
+        char chunk[1 << 16];
+        while(true) {
+            const auto n = read(fd, chunk, sizeof(chunk));
+            if(n<0) {
+                if(errno == EINTR)
+                    continue;
+                throw Exception("Cannot read from pipe");
+            }
+            if(n==0)
+                break;
+            data.insert(data.end(), chunk, chunk+n);
+
+            // fill all complete events
+            while(data.size()-begin >= sizeof(length_t)) {
+                length_t length;
+                memcpy(addressof(length), addressof(data[begin]), sizeof(length));
+                if(data.size()-begin-sizeof(length) < length)
+                    break;
+                // the event is written as streamed by the parent, without decoding it
+                event.SetStreamed(addressof(data[begin+sizeof(length)]), length);
+                tree->Fill();
+                begin += sizeof(length) + length;
+            }
+            // keep the incomplete rest only
+            if(begin>0) {
+                data.erase(data.begin(), data.begin()+begin);
+                begin = 0;
+            }
+        }
+        if(!data.empty())
+            throw Exception("Got incomplete event");
+
+        event.SetStreamed(nullptr, 0);
+        tree->Write();
+        tree->ResetBranchAddresses();
+        file.Close();
+        return EXIT_SUCCESS;
+    }
+    catch(const exception& e) {
+        LOG(ERROR) << "Event writer: " << e.what();
+    }
+    return EXIT_FAILURE;
+}
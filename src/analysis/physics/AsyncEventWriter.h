@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+#include <sys/types.h>
+
+class TTree;
+class TDirectory;
+class TBufferFile;
+
+namespace ant {
+
+struct TEvent;
+
+namespace analysis {
+
+/**
+ * @brief The AsyncEventWriter class fills treeEvents in a separate writer process
+ *
+ * Compressing and writing the baskets then no longer blocks the event processing.
+ * The events are streamed into a buffer, which is handed to the writer through a pipe
+ * in chunks no larger than the pipe's capacity. A chunk thus fits into the pipe at once,
+ * and the next one is filled while the writer works on it. Writing to the pipe blocks
+ * only if the writer falls behind by more than a chunk, so memory stays bounded.
+ *
+ * The writer fills the streamed bytes unchanged into its own treeEvents, see TEvent::SetStreamed,
+ * in a temporary file next to the output. Finish() copies the compressed baskets into the output.
+ *
+ * A process is used instead of a thread, as ROOT I/O is not thread-safe.
+ */
+class AsyncEventWriter {
+public:
+
+    /**
+     * @brief AsyncEventWriter starts the writer process
+     * @param outputfilename the temporary file is created next to it
+     * @param compression settings for the temporary file, should match the output to copy baskets unchanged
+     * @param bufferSize requested capacity of the pipe in bytes, unprivileged processes
+     *                   usually get less (see /proc/sys/fs/pipe-max-size)
+     */
+    AsyncEventWriter(const std::string& outputfilename, int compression,
+                     std::size_t bufferSize = 4 << 20);
+    ~AsyncEventWriter();
+
+    AsyncEventWriter(const AsyncEventWriter&) = delete;
+    AsyncEventWriter& operator=(const AsyncEventWriter&) = delete;
+
+    void Fill(TEvent& event);
+
+    std::uint64_t GetEntries() const { return nEntries; }
+
+    /**
+     * @brief GetChunkSize
+     * @return bytes handed to the writer at once, the granted capacity of the pipe
+     */
+    std::size_t GetChunkSize() const { return chunkSize; }
+
+    /**
+     * @brief Finish waits for the writer and copies its treeEvents into target
+     * @return the copied tree, owned by target
+     */
+    TTree* Finish(TDirectory& target);
+
+    /**
+     * @brief Abort stops the writer and discards the written events
+     */
+    void Abort();
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+protected:
+    const std::string tmpfilename;
+    std::size_t chunkSize = 1 << 16;
+
+    pid_t writer = -1;
+    int   fd = -1;
+
+    std::vector<char> buffer;
+    std::unique_ptr<TBufferFile> tbuffer;
+    std::uint64_t nEntries = 0;
+
+    void Flush();
+    bool Wait();
+
+    static int RunWriter(int fd, const std::string& filename, int compression);
+};
+
+}} // namespace ant::analysis
@@ -40,6 +40,24 @@ public:
     virtual ~Physics() {}
 
     virtual void ProcessEvent(const TEvent& event, physics::manager_t& manager) =0;
+
+    /**
+     * @brief GetNeededSections lists the sections of TEventData read in ProcessEvent
+     *
+     * Deferred sections (see TEventData::DeferredSections) needed by any physics class
+     * are decoded before ProcessEvent, the others stay empty. Override this only if
+     * the class does not read all sections, so they can actually be deferred.
+     */
+    virtual TEventData::Sections_t GetNeededSections() const { return TEventData::AllSections(); }
+
+    /**
+     * @brief TaggingAndCandidates are the sections read by analyses of the reconstructed particles,
+     * the tagger hits, trigger and target, and the clusters, candidates and the particle tree
+     */
+    static TEventData::Sections_t TaggingAndCandidates() {
+        return TEventData::Sections_t(TEventData::Section_t::Tagging) | TEventData::Section_t::Candidates;
+    }
+
     virtual void Finish() {}
     virtual void ShowResult() {}
     std::string GetName() const { return name_; }
@@ -1,7 +1,10 @@
 #include "PhysicsManager.h"
+#include "AsyncEventWriter.h"
 
 #include "utils/ParticleID.h"
 #include "input/DataReader.h"
+#include "input/ant/EventList.h"
+#include "input/ant/CalibrationCache.h"
 
 #include "tree/TSlowControl.h"
 #include "tree/TAntHeader.h"
@@ -10,8 +13,12 @@
 #include "slowcontrol/SlowControlManager.h"
 
 #include "base/ProgressCounter.h"
+#include "base/StageTimer.h"
+#include "base/OutputProfile.h"
 
 #include "TTree.h"
+#include "TFile.h"
+#include "TDirectory.h"
 
 #include <iomanip>
 
@@ -20,6 +27,10 @@ using namespace std;
 using namespace ant;
 using namespace ant::analysis;
 
+bool PhysicsManager::SaveEventLists = false;
+bool PhysicsManager::SaveCalibrationCache = false;
+bool PhysicsManager::AsyncSaveEvents = false;
+
 PhysicsManager::PhysicsManager(volatile bool* interrupt_) :
     physics(),
     interrupt(interrupt_)
@@ -70,20 +81,60 @@ void PhysicsManager::ReadFrom(
     if(physics.empty())
         throw Exception("No analysis instances activated. Cannot not analyse anything.");
 
+    // deferred sections must be decoded if any physics class reads them
+    neededSections = TEventData::Sections_t();
+    for(auto& p : physics) {
+        const auto needed = p->GetNeededSections();
+        if(TEventData::DeferredSections & needed)
+            LOG(INFO) << "Physics class " << p->GetName() << " reads deferred sections of TEventData, decoding them anyway";
+        neededSections |= needed;
+    }
+
     // prepare slowcontrol, init here since physics classes
     // register slowcontrol variables in constructor
     slowcontrol_mgr = std_ext::make_unique<SlowControlManager>();
 
 
     // prepare output of TEvents
-    treeEvents = new TTree("treeEvents","TEvent data");
+    treeEvents = nullptr;
     treeEventPtr = nullptr;
-    treeEvents->Branch("data", addressof(treeEventPtr));
+    auto outputfile = gDirectory->GetFile();
+    if(AsyncSaveEvents && !SaveEventLists && outputfile && outputfile->IsWritable()) {
+        // the tree is copied into the current directory when finished
+        eventWriterDirectory = gDirectory;
+        eventWriter = std_ext::make_unique<AsyncEventWriter>(outputfile->GetName(),
+                                                             outputfile->GetCompressionSettings());
+    }
+    else {
+        treeEvents = new TTree("treeEvents","TEvent data");
+        treeEvents->Branch("data", addressof(treeEventPtr));
+        OutputProfile::Apply(*treeEvents);
+    }
+
+    if(SaveEventLists) {
+        eventList = std_ext::make_unique<input::EventList_t>();
+        eventList->CreateBranches(new TTree(input::EventList_t::TreeName.c_str(), "Event list into treeEvents"));
+    }
+
+    if(SaveCalibrationCache) {
+        calibrationCache = std_ext::make_unique<input::CalibrationCache_t>();
+        calibrationCache->CreateBranches(new TTree(input::CalibrationCache_t::TreeName.c_str(), "Uncalibrated detector hits"));
+    }
+
+    // prepare stage timing, register the stages in order of execution
+    const auto timer_read        = StageTimer::Register("Read");
+    const auto timer_slowcontrol = StageTimer::Register("SlowControl");
+    physics_timers.clear();
+    for(auto& p : physics)
+        physics_timers.emplace_back(StageTimer::Register("Physics " + p->GetName()));
+    const auto timer_save        = StageTimer::Register("SaveEvent");
+    StageTimer::Reset();
 
     long long nEventsRead = 0;
     long long nEventsProcessed = 0;
     long long nEventsAnalyzed = 0;
     long long nEventsSaved = 0;
+    long long nEventsPrefiltered = 0;
 
     bool reached_maxevents = false;
 
@@ -116,7 +167,12 @@ void PhysicsManager::ReadFrom(
             }
 
             input::event_t event;
-            if(!TryReadEvent(event)) {
+            bool event_read = false;
+            {
+                StageTimer::Scope timer(timer_read);
+                event_read = TryReadEvent(event);
+            }
+            if(!event_read) {
                 VLOG(5) << "No more events to read, finish.";
                 reached_maxevents = true;
                 break;
@@ -124,7 +180,12 @@ void PhysicsManager::ReadFrom(
             nEventsRead++;
 
             // dump it into slowcontrol until full...
-            if(slowcontrol_mgr->ProcessEvent(move(event)))
+            bool slowcontrol_complete = false;
+            {
+                StageTimer::Scope timer(timer_slowcontrol);
+                slowcontrol_complete = slowcontrol_mgr->ProcessEvent(move(event));
+            }
+            if(slowcontrol_complete)
                 break;
             // ..or max buffersize reached: 20000 corresponds to two Acqu Scaler blocks
             if(slowcontrol_mgr->BufferSize()>20000) {
@@ -160,7 +221,11 @@ void PhysicsManager::ReadFrom(
                         break;
                 }
 
-                if(!reached_maxevents && !buf_event.WantsSkip) {
+                // prefiltered events only flow through for slowcontrol/saving
+                if(!reached_maxevents && event.prefiltered) {
+                    nEventsPrefiltered++;
+                }
+                else if(!reached_maxevents && !buf_event.WantsSkip) {
 
                     ProcessEvent(event, manager);
 
@@ -178,7 +243,10 @@ void PhysicsManager::ReadFrom(
             }
 
             // SaveEvent is the sink for events
-            SaveEvent(move(event), manager);
+            {
+                StageTimer::Scope timer(timer_save);
+                SaveEvent(move(event), manager);
+            }
 
             nEventsProcessed++;
         }
@@ -197,14 +265,71 @@ void PhysicsManager::ReadFrom(
         processed_str += std_ext::formatter() << " (" << nEventsProcessed << " processed)";
     if(nEventsRead != nEventsAnalyzed)
         processed_str += std_ext::formatter() << " (" << nEventsRead << " read)";
+    if(nEventsPrefiltered>0)
+        processed_str += std_ext::formatter() << " (" << nEventsPrefiltered << " prefiltered)";
 
 
     LOG(INFO) << "Analyzed " << nEventsAnalyzed << " events"
               << processed_str << ", speed "
               << nEventsProcessed/progress.GetTotalSecs() << " event/s";
 
-    const auto nEventsSavedTotal = treeEvents->GetEntries();
-    if(nEventsSaved==0) {
+    StageTimer::Finish();
+
+    const bool savedEventList = eventList != nullptr;
+    if(eventList) {
+        const auto nEntries = eventList->Tree->GetEntries();
+        // an event list is useless without the file it is written to
+        if(nEventsSaved==0 || eventList->Tree->GetCurrentFile() == nullptr) {
+            if(nEventsSaved>0)
+                LOG(WARNING) << "Discarding event list with " << nEventsSaved << " events, no output file";
+            delete eventList->Tree;
+        }
+        else {
+            eventList->Tree->Write();
+            const auto n_sc = nEntries - nEventsSaved;
+            LOG(INFO) << "Wrote event list with " << nEventsSaved << " events"
+                      << (n_sc>0 ? string(std_ext::formatter() << " (+slowcontrol: " << n_sc << ")") : "")
+                      << " referring to " << eventList->GetSources().size() << " source files";
+            eventList->Tree->ResetBranchAddresses();
+        }
+        eventList = nullptr;
+    }
+
+    if(calibrationCache) {
+        const auto nEntries = calibrationCache->Tree->GetEntries();
+        if(nEntries == 0) {
+            delete calibrationCache->Tree;
+        }
+        else if(calibrationCache->Tree->GetCurrentFile() != nullptr) {
+            calibrationCache->Tree->Write();
+            LOG(INFO) << "Wrote calibration cache with " << nEntries << " events: "
+                      << (double)calibrationCache->Tree->GetZipBytes()/(1 << 20) << " MB (compressed), "
+                      << (double)calibrationCache->Tree->GetZipBytes()/nEntries << " bytes/event";
+        }
+        if(nEntries>0)
+            calibrationCache->Tree->ResetBranchAddresses();
+        calibrationCache = nullptr;
+    }
+
+    if(eventWriter) {
+        // the events of the writer are only copied if needed
+        if(nEventsSaved==0) {
+            if(eventWriter->GetEntries()>0)
+                VLOG(5) << "Discarding " << eventWriter->GetEntries() << " treeEvents from slowcontrol only";
+            eventWriter->Abort();
+        }
+        else {
+            treeEvents = eventWriter->Finish(*eventWriterDirectory);
+        }
+        eventWriter = nullptr;
+        eventWriterDirectory = nullptr;
+    }
+
+    const auto nEventsSavedTotal = treeEvents ? treeEvents->GetEntries() : 0;
+    if(!treeEvents) {
+        // nothing written by event writer
+    }
+    else if(nEventsSaved==0 || savedEventList) {
         if(nEventsSavedTotal>0)
             VLOG(5) << "Deleting " << nEventsSavedTotal << " treeEvents from slowcontrol only";
         delete treeEvents;
@@ -256,8 +381,15 @@ void PhysicsManager::ProcessEvent(input::event_t& event, physics::manager_t& man
 
     event.EnsureTempBranches();
 
+    if(event.HasReconstructed())
+        event.Reconstructed().Decode(neededSections);
+    if(event.HasMCTrue())
+        event.MCTrue().Decode(neededSections);
+
     // run the physics classes
+    auto it_timer = physics_timers.begin();
     for( auto& m : physics ) {
+        StageTimer::Scope timer(*it_timer++);
         m->ProcessEvent(event, manager);
     }
 
@@ -266,9 +398,26 @@ void PhysicsManager::ProcessEvent(input::event_t& event, physics::manager_t& man
 
 void PhysicsManager::SaveEvent(input::event_t event, const physics::manager_t& manager)
 {
+    if(calibrationCache && event.HasReconstructed()) {
+        event.Reconstructed().Decode();
+        calibrationCache->Set(event.Reconstructed());
+        calibrationCache->Tree->Fill();
+    }
+
+    if(eventList && (manager.saveEvent || event.SavedForSlowControls)) {
+        if(!event.SourceFile || event.SourceEntry<0)
+            throw Exception("Cannot save event list for events not read from treeEvents");
+        eventList->Source = eventList->AddSource(*event.SourceFile);
+        eventList->Entry = event.SourceEntry;
+        eventList->ID = event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
+        eventList->SavedForSlowControls = event.SavedForSlowControls;
+        eventList->Tree->Fill();
+        return;
+    }
+
     if(manager.saveEvent || event.SavedForSlowControls) {
         // only warn if manager says it should save
-        if(!treeEvents->GetCurrentFile() && manager.saveEvent)
+        if(!eventWriter && !treeEvents->GetCurrentFile() && manager.saveEvent)
             LOG_N_TIMES(1, WARNING) << "Writing treeEvents to memory. Might be a lot of data!";
 
 
@@ -276,6 +425,11 @@ void PhysicsManager::SaveEvent(input::event_t event, const physics::manager_t& m
         if(!manager.keepReadHits && !event.SavedForSlowControls)
             event.ClearDetectorReadHits();
 
+        if(eventWriter) {
+            eventWriter->Fill(event);
+            return;
+        }
+
         treeEventPtr = addressof(event);
         treeEvents->Fill();
     }
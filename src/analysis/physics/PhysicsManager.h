@@ -2,10 +2,13 @@
 
 #include "Physics.h"
 
+#include "base/StageTimer.h"
+
 #include <memory>
 #include <queue>
 
 class TTree;
+class TDirectory;
 
 namespace ant {
 
@@ -26,14 +29,24 @@ class ParticleID;
 namespace input {
 struct event_t;
 class DataReader;
+struct EventList_t;
+struct CalibrationCache_t;
 }
 
+class AsyncEventWriter;
+
 class PhysicsManager {
 protected:
     using physics_list_t = std::list< std::unique_ptr<Physics> >;
 
     physics_list_t physics;
 
+    // sections of TEventData read by any of the physics classes
+    TEventData::Sections_t neededSections;
+
+    // stage timers for each physics class, in the same order
+    std::vector<StageTimer::id_t> physics_timers;
+
     using readers_t = std::list< std::unique_ptr<input::DataReader> >;
     readers_t amenders;
     std::unique_ptr<input::DataReader> source;
@@ -67,6 +80,16 @@ protected:
     TTree*  treeEvents;
     TEvent* treeEventPtr;
 
+    // for output of TEvents by a separate process, instead of treeEvents
+    std::unique_ptr<AsyncEventWriter> eventWriter;
+    TDirectory* eventWriterDirectory = nullptr;
+
+    // for output of event lists instead of TEvents
+    std::unique_ptr<input::EventList_t> eventList;
+
+    // for output of uncalibrated hits, in addition to other output
+    std::unique_ptr<input::CalibrationCache_t> calibrationCache;
+
 public:
 
     PhysicsManager(volatile bool* interrupt_ = nullptr);
@@ -96,6 +119,27 @@ public:
 
     virtual void ShowResults();
 
+    /**
+     * @brief SaveEventLists makes SaveEvent record only the position of the event
+     * in the input treeEvents, instead of writing the full TEvent
+     * @see input::EventList_t
+     */
+    static bool SaveEventLists;
+
+    /**
+     * @brief SaveCalibrationCache makes SaveEvent additionally record the uncalibrated
+     * detector hits of every event, which AntReader can reconstruct again
+     * @see input::CalibrationCache_t
+     */
+    static bool SaveCalibrationCache;
+
+    /**
+     * @brief AsyncSaveEvents makes SaveEvent hand the events to a separate writer process,
+     * which compresses and writes them while the next events are processed
+     * @see AsyncEventWriter
+     */
+    static bool AsyncSaveEvents;
+
     class Exception : public std::runtime_error {
         using std::runtime_error::runtime_error; // use base class constructor
     };
@@ -12,7 +12,7 @@ using namespace ant::analysis::physics;
 void CB_Energy::FillggIM(const TCluster &cl1, const TCluster &cl2, const double imass)
 {
     if(!RequireClean || (!cl2.HasFlag(TCluster::Flags_t::TouchesHoleCentral)))
-        ggIM->Fill(imass, cl1.CentralElement);
+        ggIM.Fill(imass, cl1.CentralElement);
 }
 
 CB_Energy::CB_Energy(const string& name, OptionsPtr opts) :
@@ -27,8 +27,8 @@ CB_Energy::CB_Energy(const string& name, OptionsPtr opts) :
     const BinSettings cb_channels(detector->GetNChannels());
     const BinSettings energybins(1000);
 
-    ggIM = HistFac.makeTH2D("2 neutral IM (CB,CB)", "IM [MeV]", "#",
-                            energybins, cb_channels, "ggIM");
+    ggIM = HistFac.makeChannelHistBank("2 neutral IM (CB,CB)", "IM [MeV]", "#",
+                                       energybins, cb_channels, "ggIM");
     h_cbdisplay = HistFac.make<TH2CB>("h_cbdisplay","Number of entries");
 }
 
@@ -62,12 +62,17 @@ void CB_Energy::ProcessEvent(const TEvent& event, manager_t&)
     }
 }
 
+void CB_Energy::Finish()
+{
+    ggIM.Flush();
+}
+
 void CB_Energy::ShowResult()
 {
-    auto proj = dynamic_cast<TH1D*>(ggIM->ProjectionX());
+    auto proj = dynamic_cast<TH1D*>(ggIM.Hist()->ProjectionX());
     proj->GetXaxis()->SetRangeUser(0, 300);
-    h_cbdisplay->SetElements(*ggIM->ProjectionY());
-    canvas(GetName()) << drawoption("colz") << ggIM
+    h_cbdisplay->SetElements(*ggIM.Hist()->ProjectionY());
+    canvas(GetName()) << drawoption("colz") << ggIM.Hist()
                       << h_cbdisplay
                       << proj
                       << endc;
@@ -11,7 +11,7 @@ namespace physics {
 class CB_Energy : public Physics {
 
 protected:
-    TH2* ggIM = nullptr;
+    ChannelHistBank ggIM;
     TH2CB* h_cbdisplay = nullptr;
 
     const bool RequireClean = true;
@@ -25,6 +25,7 @@ public:
     CB_Energy(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual void Finish() override;
     virtual void ShowResult() override;
 };
 
@@ -44,7 +44,7 @@ PID_Energy::PID_Energy(const string& name, OptionsPtr opts) :
     const BinSettings energybins(500, 0, 10);
 
 
-    h_pedestals = HistFac.makeTH2D(
+    h_pedestals = HistFac.makeChannelHistBank(
                       "PID Pedestals",
                       "Raw ADC value",
                       "#",
@@ -64,7 +64,7 @@ PID_Energy::PID_Energy(const string& name, OptionsPtr opts) :
                 "Bananas"
                 );
 
-    h_mip = HistFac.makeTH2D(
+    h_mip = HistFac.makeChannelHistBank(
                 "PID Minimum Ionizing Peak",
                 "PID Energy / MeV",
                 "Channel",
@@ -217,7 +217,7 @@ void PID_Energy::ProcessEvent(const TEvent& event, manager_t&)
 
         const auto& pedestal = item.Integrals.front().Uncalibrated;
 
-        h_pedestals->Fill(pedestal, channel);
+        h_pedestals.Fill(pedestal, channel);
 
         if(item.Timings.size()==1)
             h.PedestalTiming->Fill(item.Timings.front().Calibrated, pedestal);
@@ -407,7 +407,7 @@ void PID_Energy::ProcessMIP(const TEvent& event)
     // fill calibration histogram
     for (const TCandidatePtr& c : comb)
         if (c->VetoEnergy && c->Detector & Detector_t::Type_t::CB)
-            h_mip->Fill(c->VetoEnergy, c->FindVetoCluster()->CentralElement);
+            h_mip.Fill(c->VetoEnergy, c->FindVetoCluster()->CentralElement);
 }
 
 void PID_Energy::ProcessHEP(const TEvent &event)
@@ -447,6 +447,9 @@ void PID_Energy::ProcessHEP(const TEvent &event)
 
 void PID_Energy::Finish()
 {
+    h_pedestals.Flush();
+    h_mip.Flush();
+
     const auto detector = ExpConfig::Setup::GetDetector(Detector_t::Type_t::PID);
 
     h_BananaEntries = HistFac.makeTH1D("Banana Entries","Channel","",
@@ -479,7 +482,7 @@ void PID_Energy::Finish()
 void PID_Energy::ShowResult()
 {
     canvas(GetName())
-            << drawoption("colz") << h_pedestals
+            << drawoption("colz") << h_pedestals.Hist()
             << endc;
     canvas c_bananas(GetName()+": Bananas");
     canvas c_bananas_unmatched(GetName()+": Bananas Unmatched");
@@ -494,7 +497,7 @@ void PID_Energy::ShowResult()
     c_bananas_unmatched << endc;
 
     if (useMIP)
-        canvas(GetName()+": MIP") << drawoption("colz") << h_mip << endc;
+        canvas(GetName()+": MIP") << drawoption("colz") << h_mip.Hist() << endc;
 
     if (useHEP) {
         canvas(GetName()+": HEP") << drawoption("colz") << projections << endc;
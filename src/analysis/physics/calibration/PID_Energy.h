@@ -15,9 +15,9 @@ namespace physics {
 class PID_Energy : public Physics {
 
 protected:
-    TH2D* h_pedestals = nullptr;
+    ChannelHistBank h_pedestals;
     TH3D* h_bananas = nullptr;
-    TH2D* h_mip = nullptr;
+    ChannelHistBank h_mip;
 
     bool useMIP = false;
     bool useHEP = false;
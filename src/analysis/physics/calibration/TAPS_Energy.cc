@@ -25,14 +25,14 @@ TAPS_Energy::TAPS_Energy(const string& name, OptionsPtr opts) :
     const BinSettings energybins(1000);
     const BinSettings timebins(1000,-100,100);
 
-    ggIM = HistFac.makeTH2D("2 neutral IM (TAPS,CB)", "IM [MeV]", "#",
-                            energybins, taps_channels, "ggIM");
+    ggIM = HistFac.makeChannelHistBank("2 neutral IM (TAPS,CB)", "IM [MeV]", "#",
+                                       energybins, taps_channels, "ggIM");
 
 
     timing_cuts = HistFac.makeTH2D("Check timing cuts", "Time [ns]", "#",
                                    timebins, taps_channels, "timing_cuts");
 
-    h_pedestals = HistFac.makeTH2D(
+    h_pedestals = HistFac.makeChannelHistBank(
                       "TAPS Pedestals",
                       "Raw ADC value",
                       "#",
@@ -69,7 +69,7 @@ void TAPS_Energy::ProcessEvent(const TEvent& event, manager_t&)
         /// \todo check for timing hit?
         /// \todo check for trigger pattern?
         for(const auto& value : readhit.Values)
-            h_pedestals->Fill(value.Uncalibrated, readhit.Channel);
+            h_pedestals.Fill(value.Uncalibrated, readhit.Channel);
     }
 
     // invariant mass of two photons
@@ -104,7 +104,7 @@ void TAPS_Energy::ProcessEvent(const TEvent& event, manager_t&)
                     double weight = -1.0;
                     if(ring > 4 || fabs(cand_taps->Time) < 5) {
                         weight = 1.0;
-                        ggIM->Fill(gg.M(),ch);
+                        ggIM.Fill(gg.M(),ch);
                     }
                     timing_cuts->Fill(cand_taps->Time, ch, weight);
                 }
@@ -181,13 +181,19 @@ void TAPS_Energy::ProcessEvent(const TEvent& event, manager_t&)
     }
 }
 
+void TAPS_Energy::Finish()
+{
+    ggIM.Flush();
+    h_pedestals.Flush();
+}
+
 void TAPS_Energy::ShowResult()
 {
-    h_tapsdisplay->SetElements(*ggIM->ProjectionY());
+    h_tapsdisplay->SetElements(*ggIM.Hist()->ProjectionY());
 
-    canvas(GetName()) << drawoption("colz") << ggIM
+    canvas(GetName()) << drawoption("colz") << ggIM.Hist()
                       << drawoption("colz") << timing_cuts
-                      << drawoption("colz") << h_pedestals
+                      << drawoption("colz") << h_pedestals.Hist()
                       << h_tapsdisplay
                       << endc;
     if(ggIM_mult) {
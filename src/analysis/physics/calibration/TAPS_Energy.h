@@ -18,10 +18,10 @@ namespace physics {
 class TAPS_Energy : public Physics {
 
 protected:
-    TH2D* ggIM = nullptr;
+    ChannelHistBank ggIM;
     TH3D* ggIM_mult = nullptr;
     TH2D* timing_cuts = nullptr;
-    TH2D* h_pedestals = nullptr;
+    ChannelHistBank h_pedestals;
     TH2TAPS* h_tapsdisplay = nullptr;
 
     std::shared_ptr<expconfig::detector::TAPS> taps_detector;
@@ -47,6 +47,7 @@ public:
     TAPS_Energy(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual void Finish() override;
     virtual void ShowResult() override;
 };
 
@@ -24,21 +24,21 @@ Time::Time(const Detector_t::Type_t& detectorType,
     const BinSettings TimeBins = isTagger ?
                                      BinSettings::RoundToBinSize(BinSettings(2000,-400,400), calibration::converter::Gains::CATCH_TDC) : BinSettings(2000,-400,400);
 
-    hTime = HistFac.makeTH2D(detectorName + " - Time",
-                             "time [ns]",
-                             detectorName + " channel",
-                             TimeBins,
-                             BinSettings(Detector->GetNChannels()),
-                             "Time"
-                             );
-    hTimeToF = HistFac.makeTH2D(detectorName + " - Time for ToF",
-                             "time [ns]",
-                             detectorName + " channel",
-                             BinSettings(1000,-50,50),
-                             BinSettings(Detector->GetNChannels()),
-                             "Time_ToF" // for TAPS_ToF offsets...
-                             );
-    hTimeToTagger = HistFac.makeTH2D(
+    hTime = HistFac.makeChannelHistBank(detectorName + " - Time",
+                                        "time [ns]",
+                                        detectorName + " channel",
+                                        TimeBins,
+                                        BinSettings(Detector->GetNChannels()),
+                                        "Time"
+                                        );
+    hTimeToF = HistFac.makeChannelHistBank(detectorName + " - Time for ToF",
+                                        "time [ns]",
+                                        detectorName + " channel",
+                                        BinSettings(1000,-50,50),
+                                        BinSettings(Detector->GetNChannels()),
+                                        "Time_ToF" // for TAPS_ToF offsets...
+                                        );
+    hTimeToTagger = HistFac.makeChannelHistBank(
                         detectorName + " - Time relative to tagger",
                         "time [ns]",
                         detectorName + " channel",
@@ -51,17 +51,22 @@ Time::Time(const Detector_t::Type_t& detectorType,
                                 "#",
                                 BinSettings(500,-15,15),
                                 "hCBTriggerTiming");
-    hTimeMultiplicity = HistFac.makeTH2D(detectorName + " - Time Hit Multiplicity",
-                                         "multiplicity",
-                                         detectorName + " channel",
-                                         BinSettings(8),
-                                         BinSettings(Detector->GetNChannels()),
-                                         "hTimeMultiplicity"
-                                         );
-
-
-
+    hTimeMultiplicity = HistFac.makeChannelHistBank(detectorName + " - Time Hit Multiplicity",
+                                                    "multiplicity",
+                                                    detectorName + " channel",
+                                                    BinSettings(8),
+                                                    BinSettings(Detector->GetNChannels()),
+                                                    "hTimeMultiplicity"
+                                                    );
+
+    multiplicity.resize(Detector->GetNChannels(), 0);
+}
 
+void Time::CountHit(unsigned channel)
+{
+    auto& n = multiplicity.at(channel);
+    if(n++ == 0)
+        multiplicity_channels.push_back(channel);
 }
 
 void Time::ProcessEvent(const TEvent& event, manager_t&)
@@ -69,15 +74,13 @@ void Time::ProcessEvent(const TEvent& event, manager_t&)
     const double CBTimeAvg = event.Reconstructed().Trigger.CBTiming;
     hCBTriggerTiming->Fill(CBTimeAvg);
 
-    std::map<unsigned, unsigned> multiplicity;
-
     // handle Tagger differently
     if(isTagger)
     {
         for (const auto& tHit: event.Reconstructed().TaggerHits) {
-            hTime->Fill(tHit.Time, tHit.Channel);
-            hTimeToF->Fill(tHit.Time - CBTimeAvg, tHit.Channel);
-            ++multiplicity[tHit.Channel];
+            hTime.Fill(tHit.Time, tHit.Channel);
+            hTimeToF.Fill(tHit.Time - CBTimeAvg, tHit.Channel);
+            CountHit(tHit.Channel);
         }
     }
     else {
@@ -85,36 +88,46 @@ void Time::ProcessEvent(const TEvent& event, manager_t&)
             for(const TCluster& cluster: cand.Clusters) {
                 if(cluster.DetectorType != Detector->Type)
                     continue;
-                hTime->Fill(cluster.Time, cluster.CentralElement);
-                ++multiplicity[cluster.CentralElement];
+                hTime.Fill(cluster.Time, cluster.CentralElement);
+                CountHit(cluster.CentralElement);
                 if(taps_detector) {
                     const double tof = taps_detector->GetTimeOfFlight(
                                            cluster.Time,
                                            cluster.CentralElement,
                                            CBTimeAvg);
-                    hTimeToF->Fill(tof, cluster.CentralElement);
+                    hTimeToF.Fill(tof, cluster.CentralElement);
                 }
                 for(const auto& taggerhit : event.Reconstructed().TaggerHits) {
                     const double relative_time = cluster.Time - taggerhit.Time;
-                    hTimeToTagger->Fill(relative_time, cluster.CentralElement);
+                    hTimeToTagger.Fill(relative_time, cluster.CentralElement);
                 }
             }
         }
     }
-    for(auto& it_mult : multiplicity) {
-        hTimeMultiplicity->Fill(it_mult.second, it_mult.first);
+    for(auto channel : multiplicity_channels) {
+        hTimeMultiplicity.Fill(multiplicity[channel], channel);
+        multiplicity[channel] = 0;
     }
+    multiplicity_channels.clear();
+}
+
+void Time::Finish()
+{
+    hTime.Flush();
+    hTimeToF.Flush();
+    hTimeToTagger.Flush();
+    hTimeMultiplicity.Flush();
 }
 
 void Time::ShowResult()
 {
     canvas(GetName())
             << drawoption("colz")
-            << hTime
-            << hTimeToTagger
+            << hTime.Hist()
+            << hTimeToTagger.Hist()
             << hCBTriggerTiming
-            << hTimeToF
-            << hTimeMultiplicity
+            << hTimeToF.Hist()
+            << hTimeMultiplicity.Hist()
             << endc;
 }
 
@@ -17,12 +17,17 @@ class Time : public Physics {
 
 protected:
 
-    TH2D* hTime;
-    TH2D* hTimeToF;
-    TH2D* hTimeToTagger;
-    TH2D* hTimeMultiplicity;
+    ChannelHistBank hTime;
+    ChannelHistBank hTimeToF;
+    ChannelHistBank hTimeToTagger;
+    ChannelHistBank hTimeMultiplicity;
     TH1D* hCBTriggerTiming;
 
+    // hits per channel in current event, and the channels hit
+    std::vector<unsigned> multiplicity;
+    std::vector<unsigned> multiplicity_channels;
+    void CountHit(unsigned channel);
+
     std::shared_ptr<Detector_t> Detector;
     bool isTagger;
     std::shared_ptr<expconfig::detector::TAPS> taps_detector;
@@ -34,6 +39,7 @@ public:
          const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual void Finish() override;
     virtual void ShowResult() override;
 };
 
@@ -38,6 +38,7 @@ public:
     CandidatesAnalysis(const std::string& name,OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t&) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void Finish() override;
     virtual void ShowResult() override;
 };
@@ -38,6 +38,8 @@ protected:
 public:
     DataOverviewBase(const std::string& name, OptionsPtr opts);
     virtual ~DataOverviewBase();
+
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
 };
 
 /**
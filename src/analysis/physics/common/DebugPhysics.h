@@ -39,6 +39,7 @@ public:
     virtual ~DebugPIDAlignment();
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
 };
 
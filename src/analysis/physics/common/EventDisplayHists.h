@@ -25,6 +25,7 @@ public:
     virtual ~EventDisplayHists();
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
 };
 
 }
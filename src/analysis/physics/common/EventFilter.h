@@ -32,6 +32,7 @@ public:
     virtual ~EventFilter();
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
 };
 
 }
@@ -56,6 +56,7 @@ public:
     ExtractResolutions(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
 };
 
@@ -73,6 +73,7 @@ struct ExtractScalers: public Physics {
     virtual ~ExtractScalers();
 
     virtual void ProcessEvent(const TEvent& ev, manager_t&) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void Finish() override;
     virtual void ShowResult() override;
 
@@ -156,14 +156,10 @@ void IMCombFitPlots::ProcessEvent(const TEvent& event, manager_t&)
             dEvE_all_combined.Fill(fitted_proton->E - ParticleTypeDatabase::Proton.Mass(), fitted_proton->Candidate->VetoEnergy);
         }
 
-        for (auto c = utils::makeCombination(photons, 2); !c.Done(); ++c) {
-            const LorentzVec sum = sumlv(c.begin(), c.end());
-            raw_2.at(comb.size() - MinNGamma()).Fill(sum.M());
-        }
-        for (auto c = utils::makeCombination(fitted_photons, 2); !c.Done(); ++c) {
-            const LorentzVec sum = sumlv(c.begin(), c.end());
-            fit_2.at(comb.size() - MinNGamma()).Fill(sum.M());
-        }
+        for (auto im : im_combinations.Calc(photons, 2))
+            raw_2.at(comb.size() - MinNGamma()).Fill(im);
+        for (auto im : im_combinations.Calc(fitted_photons, 2))
+            fit_2.at(comb.size() - MinNGamma()).Fill(im);
     }
 }
 
@@ -44,6 +44,8 @@ public:
     utils::UncertaintyModelPtr model;
     std::vector<utils::KinFitter> kinfit;
 
+    utils::IMCombinations im_combinations;
+
     unsigned MinNGamma() const noexcept { return 2; }
     unsigned MaxNGamma() const noexcept { return MAX_GAMMA; }
 
@@ -61,6 +63,7 @@ public:
     bool find_best_comb(const TTaggerHit&, TCandidatePtrList&, TParticleList&, TParticlePtr&);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
     virtual void Finish() override;
 };
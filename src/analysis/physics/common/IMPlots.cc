@@ -42,15 +42,16 @@ void IMPlots::ProcessEvent(const TEvent& event, manager_t&)
     auto recon_particles = utils::ParticleTypeList::Make(event.Reconstructed().Candidates);
     const auto& photons = recon_particles.Get(ParticleTypeDatabase::Photon);
 
+    im_combinations.Vecs().Assign(photons);
+
     for(unsigned n = MinNGamma(); n<MaxNGamma(); ++n) {
-        for( auto comb = utils::makeCombination(photons,n); !comb.Done(); ++comb) {
-            const LorentzVec sum = sumlv(comb.begin(), comb.end());
-                for(const auto& h : event.Reconstructed().TaggerHits) {
-                    prs.SetTaggerHit(h.Time);
-                    m.at(n - MinNGamma()).Fill(sum.M());
-                }
-            }
-       }
+        const auto& ims = im_combinations.Calc(n);
+        for(const auto& h : event.Reconstructed().TaggerHits) {
+            prs.SetTaggerHit(h.Time);
+            for(auto im : ims)
+                m.at(n - MinNGamma()).Fill(im);
+        }
+    }
 }
 
 void IMPlots::ShowResult()
@@ -2,6 +2,7 @@
 
 #include "analysis/physics/Physics.h"
 #include "plot/PromptRandomHist.h"
+#include "utils/combinatorics.h"
 #include <vector>
 
 class TH1D;
@@ -16,6 +17,7 @@ public:
 
     PromptRandom::Switch prs;
     std::vector<PromptRandom::Hist1> m;
+    utils::IMCombinations im_combinations;
     unsigned MinNGamma() const noexcept { return 2;}
     unsigned MaxNGamma() const noexcept { return unsigned(m.size())+2; }
 
@@ -26,6 +28,7 @@ public:
     IMPlots(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
 };
 
@@ -51,6 +54,7 @@ public:
     virtual ~Symmetric2Gamma();
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
 };
 
@@ -94,6 +98,7 @@ public:
     virtual ~IM_CB_TAPS_Plots();
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
 };
 
@@ -28,6 +28,7 @@ public:
     virtual ~MCChannels();
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
     virtual void Finish() override;
 
@@ -42,6 +42,7 @@ public:
     MCGunCheck(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void Finish() override;
     virtual void ShowResult() override;
 
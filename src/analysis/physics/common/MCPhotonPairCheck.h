@@ -48,6 +48,7 @@ public:
     MCPhotonPairCheck(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void Finish() override;
     virtual void ShowResult() override;
 
@@ -159,6 +159,7 @@ public:
     MCReconstructCheck(const std::string& name, OptionsPtr opts);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void Finish() override;
     virtual void ShowResult() override;
 };
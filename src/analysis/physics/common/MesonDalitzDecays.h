@@ -200,6 +200,7 @@ public:
                                 double& best_prob_fit);
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void ShowResult() override;
 
     using decaytree_t = ant::Tree<const ParticleTypeDatabase::Type&>;
@@ -51,6 +51,7 @@ struct ProcessTaggEff: public Physics {
     virtual ~ProcessTaggEff();
 
     virtual void ProcessEvent(const TEvent& ev, manager_t&) override;
+    virtual TEventData::Sections_t GetNeededSections() const override { return TaggingAndCandidates(); }
     virtual void Finish() override;
     virtual void ShowResult() override;
 
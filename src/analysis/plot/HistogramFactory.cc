@@ -1,6 +1,7 @@
 #include "HistogramFactory.h"
 
 #include "base/std_ext/string.h"
+#include "base/OutputProfile.h"
 
 #include "TDirectory.h"
 #include "TGraph.h"
@@ -186,6 +187,27 @@ TH2D* HistogramFactory::makeTH2D(
     return h;
 }
 
+ChannelHistBank HistogramFactory::makeChannelHistBank(
+        const string& title,
+        const string& xlabel,
+        const string& ylabel,
+        const BinSettings& xbins,
+        const BinSettings& ybins,
+        const string& name, bool sumw2) const
+{
+    return makeChannelHistBank(title, {xlabel, xbins}, {ylabel, ybins}, name, sumw2);
+}
+
+ChannelHistBank HistogramFactory::makeChannelHistBank(
+        const string& title,
+        const AxisSettings& x_axis_settings,
+        const AxisSettings& y_axis_settings,
+        const string& name, bool sumw2) const
+{
+    auto h = makeTH2D(title, x_axis_settings, y_axis_settings, name, sumw2);
+    return ChannelHistBank(h, x_axis_settings, y_axis_settings);
+}
+
 TH3D* HistogramFactory::makeTH3D(
         const string &title,
         const string &xlabel,
@@ -253,10 +275,80 @@ TGraphErrors* HistogramFactory::makeGraphErrors(
     return g;
 }
 
+namespace {
+
+// most physics classes create the branches with TTree::Branch after makeTTree,
+// so the output profile is applied when the branches exist, before the first basket is written.
+// It is still written as a plain TTree, as IsA() and Streamer() are not overridden
+struct ProfiledTTree : TTree {
+    using TTree::TTree;
+    bool profileApplied = false;
+
+    virtual Int_t Fill() override {
+        if(!profileApplied) {
+            profileApplied = true;
+            OutputProfile::Apply(*this);
+        }
+        return TTree::Fill();
+    }
+};
+
+}
+
 TTree* HistogramFactory::makeTTree(const string& name) const
 {
     // trees do not autogenerate histograms, thus provide empty prefix
-    return make<TTree>(GetNextName(name, "").c_str(), MakeTitle(name.c_str()).c_str());
+    return make<ProfiledTTree>(GetNextName(name, "").c_str(), MakeTitle(name.c_str()).c_str());
+}
+
+ChannelHistBank::ChannelHistBank(TH2D* h_, const BinSettings& xbins, const BinSettings& ybins) :
+    h(h_),
+    x_axis(xbins),
+    y_axis(ybins),
+    statOverflows(TH1::GetStatOverflows()),
+    counts(size_t(xbins.Bins()+2)*(ybins.Bins()+2), 0)
+{
+}
+
+void ChannelHistBank::Flush()
+{
+    if(entries == 0)
+        return;
+
+    // get the stats before touching the bin contents
+    double stats[TH1::kNstat] = {};
+    h->GetStats(stats);
+
+    auto sumw2 = h->GetSumw2N() > 0 ? h->GetSumw2()->GetArray() : nullptr;
+    for(size_t bin=0;bin<counts.size();bin++) {
+        const auto n = counts[bin];
+        if(n == 0)
+            continue;
+        h->AddBinContent(int(bin), n);
+        if(sumw2)
+            sumw2[bin] += n;
+        counts[bin] = 0;
+    }
+
+    // weights are always one, so sum of w^2 equals sum of w
+    stats[0] += sumw;
+    stats[1] += sumw;
+    stats[2] += sumwx;
+    stats[3] += sumwx2;
+    stats[4] += sumwy;
+    stats[5] += sumwy2;
+    stats[6] += sumwxy;
+    h->PutStats(stats);
+    h->SetEntries(h->GetEntries() + entries);
+
+    entries = 0;
+    sumw = sumwx = sumwx2 = sumwy = sumwy2 = sumwxy = 0;
+}
+
+TH2D* ChannelHistBank::Hist()
+{
+    Flush();
+    return h;
 }
 
 HistogramFactory::DirStackPush::DirStackPush(const HistogramFactory& hf): dir(gDirectory)
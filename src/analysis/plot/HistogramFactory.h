@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 class TDirectory;
 class TNamed;
@@ -18,6 +19,90 @@ class TGraphErrors;
 namespace ant {
 namespace analysis {
 
+/**
+ * @brief The ChannelHistBank class fills a TH2D of some value versus detector channel
+ *
+ * Calibration physics classes fill such histograms for every hit or pair of hits.
+ * The bank finds the bins arithmetically from the uniform binning and counts
+ * in a dense array with the same (channel-major) layout as the TH2D itself,
+ * without going through ROOT's generic TAxis and TH2::Fill machinery.
+ *
+ * Flush() adds the counts to the TH2D, which then is identical (contents, entries and
+ * statistics) to one filled directly. Call it in Finish(), as the TH2D is written
+ * afterwards. Hist() flushes as well, before returning the TH2D.
+ */
+class ChannelHistBank {
+public:
+    ChannelHistBank() = default;
+
+    void Fill(double x, double y) {
+        entries++;
+        const int binx = x_axis.FindBin(x);
+        const int biny = y_axis.FindBin(y);
+        counts[std::size_t(biny)*(x_axis.Bins+2) + binx]++;
+        // like TH2::Fill, the statistics ignore under/overflows
+        if(!statOverflows &&
+           (binx == 0 || binx > x_axis.Bins || biny == 0 || biny > y_axis.Bins))
+            return;
+        sumw   += 1;
+        sumwx  += x;
+        sumwx2 += x*x;
+        sumwy  += y;
+        sumwy2 += y*y;
+        sumwxy += x*y;
+    }
+
+    /**
+     * @brief Flush adds the pending counts to the TH2D
+     */
+    void Flush();
+
+    /**
+     * @brief Hist returns the underlying TH2D, after flushing pending counts to it
+     */
+    TH2D* Hist();
+
+    explicit operator bool() const { return h != nullptr; }
+
+protected:
+    friend class HistogramFactory;
+
+    ChannelHistBank(TH2D* h_, const BinSettings& xbins, const BinSettings& ybins);
+
+    struct axis_t {
+        int    Bins  = 0;
+        double Min   = 0;
+        double Max   = 0;
+        double Width = 0;
+        axis_t() = default;
+        explicit axis_t(const BinSettings& bins) :
+            Bins(bins.Bins()), Min(bins.Start()), Max(bins.Stop()), Width(bins.Stop()-bins.Start())
+        {}
+        // same arithmetic as TAxis::FindBin for fixed bins, NaN ends up in the overflow bin
+        int FindBin(double v) const {
+            if(v < Min)
+                return 0;
+            if(!(v < Max))
+                return Bins+1;
+            return 1 + int(Bins*(v-Min)/Width);
+        }
+    };
+
+    TH2D*  h = nullptr;
+    axis_t x_axis;
+    axis_t y_axis;
+    bool   statOverflows = false;
+
+    std::vector<std::uint32_t> counts; // including under/overflow bins, as TH2D::fArray
+    std::uint64_t entries = 0;
+    double sumw   = 0;
+    double sumwx  = 0;
+    double sumwx2 = 0;
+    double sumwy  = 0;
+    double sumwy2 = 0;
+    double sumwxy = 0;
+};
+
 class HistogramFactory {
 private:
 
@@ -98,6 +183,26 @@ public:
             const std::string& name="",
             bool  sumw2 = false) const;
 
+    /**
+     * @brief makeChannelHistBank creates the TH2D as makeTH2D, but returns a bank to fill it
+     * @note The y axis is meant to be the detector channel, any uniform binning works though
+     */
+    ChannelHistBank makeChannelHistBank(
+            const std::string& title,
+            const std::string& xlabel,
+            const std::string& ylabel,
+            const BinSettings& xbins,
+            const BinSettings& ybins,
+            const std::string& name="",
+            bool  sumw2 = false) const;
+
+    ChannelHistBank makeChannelHistBank(
+            const std::string& title,
+            const AxisSettings& x_axis_settings,
+            const AxisSettings& y_axis_settings,
+            const std::string& name="",
+            bool  sumw2 = false) const;
+
     //__attribute__((deprecated)) // enable this when AxisSettings interface accepted
     TH3D* makeTH3D(
             const std::string& title,
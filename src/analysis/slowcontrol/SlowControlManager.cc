@@ -54,6 +54,10 @@ bool SlowControlManager::ProcessEvent(input::event_t event)
     bool wants_skip = false;
     bool all_complete = true;
 
+    // the processors need the slowcontrol items, even if their decoding was deferred
+    if(!processors.empty() && event.HasReconstructed())
+        event.Reconstructed().Decode(TEventData::Section_t::SlowControls);
+
     for(auto& p : processors) {
 
         TEventData& reconstructed = event.Reconstructed();
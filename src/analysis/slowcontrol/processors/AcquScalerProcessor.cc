@@ -12,7 +12,7 @@ Processor::return_t AcquScalerVector::ProcessEventData(const TEventData& recon,
                                                        manager_t& manager) {
     // search for the TSlowControl with the name
     for(const TSlowControl& sc : recon.SlowControls) {
-        if(sc.Name != name)
+        if(sc.GetNameID() != nameID)
             continue;
         if(sc.Validity != TSlowControl::Validity_t::Backward)
             throw Exception("Encountered AcquScaler with forward validity. That's strange.");
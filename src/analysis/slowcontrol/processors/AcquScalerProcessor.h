@@ -13,7 +13,7 @@ namespace processor {
 
 struct AcquScalerVector : Processor {
 
-    AcquScalerVector(const std::string& name) : name(name) {}
+    AcquScalerVector(const std::string& name) : nameID(TSlowControl::InternName(name)) {}
 
     using value_t = decltype(TSlowControl::Payload_Int);
 
@@ -21,12 +21,14 @@ struct AcquScalerVector : Processor {
 
     virtual void PopQueue() override;
 
+    // returns a copy, the queued value is gone after PopQueue()
     value_t Get() const;
 
 
 private:
     bool firstScalerSeen = false;
-    const std::string name;
+    // dispatch by interned name, see TSlowControl::GetNameID
+    const std::uint32_t nameID;
     std::queue<value_t> queue;
 };
 
@@ -0,0 +1,456 @@
+#include "EventDiff.h"
+
+#include "analysis/input/event_t.h"
+
+#include "tree/TEventData.h"
+#include "base/std_ext/string.h"
+
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+using namespace ant::analysis::utils;
+
+EventDiff::EventDiff() :
+    EventDiff(Options_t())
+{
+}
+
+EventDiff::EventDiff(const Options_t& options_) :
+    options(options_)
+{
+}
+
+void EventDiff::BeginEvent(const TID& id)
+{
+    current_id = addressof(id);
+    current_differs = false;
+    current_event++;
+    path.clear();
+}
+
+bool EventDiff::EndEvent()
+{
+    summary.Compared++;
+    if(current_differs)
+        summary.Differing++;
+    current_id = nullptr;
+    return !current_differs;
+}
+
+bool EventDiff::Compare(const input::event_t& a, const input::event_t& b)
+{
+    static const TID no_id;
+    BeginEvent(a.HasReconstructed() ? a.Reconstructed().ID :
+               a.HasMCTrue() ? a.MCTrue().ID : no_id);
+
+    prefix = "Reconstructed";
+    if(a.HasReconstructed() != b.HasReconstructed())
+        Report("", "present", std_ext::formatter() << a.HasReconstructed() << " != " << b.HasReconstructed());
+    else if(a.HasReconstructed())
+        CompareData(a.Reconstructed(), b.Reconstructed(), prefix);
+
+    prefix = "MCTrue";
+    if(a.HasMCTrue() != b.HasMCTrue())
+        Report("", "present", std_ext::formatter() << a.HasMCTrue() << " != " << b.HasMCTrue());
+    else if(a.HasMCTrue())
+        CompareData(a.MCTrue(), b.MCTrue(), prefix);
+
+    prefix = "Event";
+    if(a.SavedForSlowControls != b.SavedForSlowControls)
+        Report("", "SavedForSlowControls", std_ext::formatter()
+               << a.SavedForSlowControls << " != " << b.SavedForSlowControls);
+
+    return EndEvent();
+}
+
+void EventDiff::AddOnlyFirst(const TID& id)
+{
+    summary.OnlyFirst++;
+    auto& field = summary.Fields["Event only in first"];
+    field.Events++;
+    if(field.Examples.size() < options.MaxExamples)
+        field.Examples.emplace_back(std_ext::formatter() << id);
+}
+
+void EventDiff::AddOnlySecond(const TID& id)
+{
+    summary.OnlySecond++;
+    auto& field = summary.Fields["Event only in second"];
+    field.Events++;
+    if(field.Examples.size() < options.MaxExamples)
+        field.Examples.emplace_back(std_ext::formatter() << id);
+}
+
+bool EventDiff::Equal(double a, double b) const
+{
+    if(a == b)
+        return true;
+    if(std::isnan(a) || std::isnan(b))
+        return std::isnan(a) && std::isnan(b);
+    const double d = std::abs(a-b);
+    return d <= options.AbsTolerance ||
+           d <= options.RelTolerance*std::max(std::abs(a), std::abs(b));
+}
+
+void EventDiff::Report(const char* base, const char* leaf, const string& values)
+{
+    current_differs = true;
+
+    string name = prefix + ".";
+    if(base[0] != '\0')
+        name += string(base) + ".";
+    name += leaf;
+
+    // count events, not differences
+    auto& last = last_event[name];
+    if(last == current_event)
+        return;
+    last = current_event;
+
+    auto& field = summary.Fields[name];
+    field.Events++;
+    if(field.Examples.size() >= options.MaxExamples)
+        return;
+
+    // fill in the indices
+    string where;
+    auto it_index = path.begin();
+    for(size_t i=0;i<name.size();i++) {
+        if(name[i] == '[' && i+1<name.size() && name[i+1] == ']' && it_index != path.end()) {
+            where += "[" + to_string(*it_index++) + "]";
+            i++;
+            continue;
+        }
+        where += name[i];
+    }
+    std_ext::formatter example;
+    if(current_id)
+        example << *current_id << " ";
+    example << where << ": " << values;
+    field.Examples.emplace_back(example);
+}
+
+void EventDiff::diff_float(const char* base, const char* leaf, double a, double b)
+{
+    if(Equal(a, b))
+        return;
+    Report(base, leaf, std_ext::formatter() << setprecision(17) << a << " != " << b);
+}
+
+void EventDiff::diff_int(const char* base, const char* leaf, int64_t a, int64_t b)
+{
+    if(a == b)
+        return;
+    Report(base, leaf, std_ext::formatter() << a << " != " << b);
+}
+
+void EventDiff::diff_string(const char* base, const char* leaf, const string& a, const string& b)
+{
+    if(a == b)
+        return;
+    Report(base, leaf, "'" + a + "' != '" + b + "'");
+}
+
+bool EventDiff::diff_size(const char* base, const char* leaf, size_t a, size_t b)
+{
+    if(a == b)
+        return true;
+    Report(base, leaf, std_ext::formatter() << a << " != " << b);
+    return false;
+}
+
+namespace {
+
+// pushes the index of a nested container onto the path, pops it when done
+struct path_push {
+    vector<unsigned>& path;
+    path_push(vector<unsigned>& path_, unsigned index) : path(path_) { path.push_back(index); }
+    ~path_push() { path.pop_back(); }
+};
+
+template<typename T>
+int64_t to_int(const T& v) { return static_cast<int64_t>(v); }
+
+}
+
+void EventDiff::CompareCluster(const char* base, const TCluster& a, const TCluster& b)
+{
+    diff_float(base, "Energy",         a.Energy,         b.Energy);
+    diff_float(base, "Time",           a.Time,           b.Time);
+    diff_float(base, "Position.x",     a.Position.x,     b.Position.x);
+    diff_float(base, "Position.y",     a.Position.y,     b.Position.y);
+    diff_float(base, "Position.z",     a.Position.z,     b.Position.z);
+    diff_int  (base, "DetectorType",   to_int(a.DetectorType), to_int(b.DetectorType));
+    diff_int  (base, "CentralElement", a.CentralElement, b.CentralElement);
+    diff_int  (base, "Flags",          a.Flags,          b.Flags);
+    diff_float(base, "ShortEnergy",    a.ShortEnergy,    b.ShortEnergy);
+
+    diff_size(base, "Hits.size", a.Hits.size(), b.Hits.size());
+    const auto nHits = min(a.Hits.size(), b.Hits.size());
+    for(size_t i=0;i<nHits;i++) {
+        path_push p(path, i);
+        const auto& ha = a.Hits[i];
+        const auto& hb = b.Hits[i];
+        diff_int  (base, "Hits[].Channel", ha.Channel, hb.Channel);
+        diff_float(base, "Hits[].Energy",  ha.Energy,  hb.Energy);
+        diff_float(base, "Hits[].Time",    ha.Time,    hb.Time);
+        diff_size (base, "Hits[].Data.size", ha.Data.size(), hb.Data.size());
+        const auto nData = min(ha.Data.size(), hb.Data.size());
+        for(size_t j=0;j<nData;j++) {
+            path_push p(path, j);
+            diff_int  (base, "Hits[].Data[].Type", to_int(ha.Data[j].Type), to_int(hb.Data[j].Type));
+            diff_float(base, "Hits[].Data[].Uncalibrated", ha.Data[j].Value.Uncalibrated, hb.Data[j].Value.Uncalibrated);
+            diff_float(base, "Hits[].Data[].Calibrated",   ha.Data[j].Value.Calibrated,   hb.Data[j].Value.Calibrated);
+        }
+    }
+}
+
+bool EventDiff::CompareData(const TEventData& a, const TEventData& b, const string& prefix_)
+{
+    const bool standalone = current_id == nullptr;
+    if(standalone)
+        BeginEvent(a.ID);
+    prefix = prefix_;
+    const bool differed_before = current_differs;
+    current_differs = false;
+
+    if(a.ID != b.ID)
+        Report("", "ID", std_ext::formatter() << a.ID << " != " << b.ID);
+
+    // DetectorReadHits
+    diff_size("", "DetectorReadHits.size", a.DetectorReadHits.size(), b.DetectorReadHits.size());
+    for(size_t i=0;i<min(a.DetectorReadHits.size(), b.DetectorReadHits.size());i++) {
+        path_push p(path, i);
+        const auto& ha = a.DetectorReadHits[i];
+        const auto& hb = b.DetectorReadHits[i];
+        const char* base = "DetectorReadHits[]";
+        diff_int(base, "DetectorType", to_int(ha.DetectorType), to_int(hb.DetectorType));
+        diff_int(base, "ChannelType",  to_int(ha.ChannelType),  to_int(hb.ChannelType));
+        diff_int(base, "Channel",      ha.Channel, hb.Channel);
+        if(ha.RawData != hb.RawData)
+            Report(base, "RawData", std_ext::formatter() << ha.RawData.size() << " bytes differ from "
+                   << hb.RawData.size() << " bytes");
+        if(ha.ValueBits != hb.ValueBits)
+            Report(base, "ValueBits", std_ext::formatter() << ha.ValueBits.size() << " bits differ from "
+                   << hb.ValueBits.size() << " bits");
+        diff_size(base, "Values.size", ha.Values.size(), hb.Values.size());
+        for(size_t j=0;j<min(ha.Values.size(), hb.Values.size());j++) {
+            path_push p(path, j);
+            diff_float(base, "Values[].Uncalibrated", ha.Values[j].Uncalibrated, hb.Values[j].Uncalibrated);
+            diff_float(base, "Values[].Calibrated",   ha.Values[j].Calibrated,   hb.Values[j].Calibrated);
+        }
+    }
+
+    // SlowControls
+    diff_size("", "SlowControls.size", a.SlowControls.size(), b.SlowControls.size());
+    for(size_t i=0;i<min(a.SlowControls.size(), b.SlowControls.size());i++) {
+        path_push p(path, i);
+        const auto& sa = a.SlowControls[i];
+        const auto& sb = b.SlowControls[i];
+        const char* base = "SlowControls[]";
+        diff_int   (base, "Type",        to_int(sa.Type),     to_int(sb.Type));
+        diff_int   (base, "Validity",    to_int(sa.Validity), to_int(sb.Validity));
+        diff_int   (base, "Timestamp",   sa.Timestamp,        sb.Timestamp);
+        diff_string(base, "Name",        sa.GetName(),        sb.GetName());
+        diff_string(base, "Description", sa.Description,      sb.Description);
+        if(diff_size(base, "Payload_Int.size", sa.Payload_Int.size(), sb.Payload_Int.size())) {
+            for(size_t j=0;j<sa.Payload_Int.size();j++) {
+                path_push p(path, j);
+                diff_int(base, "Payload_Int[].Key",   sa.Payload_Int[j].Key,   sb.Payload_Int[j].Key);
+                diff_int(base, "Payload_Int[].Value", sa.Payload_Int[j].Value, sb.Payload_Int[j].Value);
+            }
+        }
+        if(diff_size(base, "Payload_Float.size", sa.Payload_Float.size(), sb.Payload_Float.size())) {
+            for(size_t j=0;j<sa.Payload_Float.size();j++) {
+                path_push p(path, j);
+                diff_int  (base, "Payload_Float[].Key",   sa.Payload_Float[j].Key,   sb.Payload_Float[j].Key);
+                diff_float(base, "Payload_Float[].Value", sa.Payload_Float[j].Value, sb.Payload_Float[j].Value);
+            }
+        }
+        if(diff_size(base, "Payload_String.size", sa.Payload_String.size(), sb.Payload_String.size())) {
+            for(size_t j=0;j<sa.Payload_String.size();j++) {
+                path_push p(path, j);
+                diff_int   (base, "Payload_String[].Key",   sa.Payload_String[j].Key,   sb.Payload_String[j].Key);
+                diff_string(base, "Payload_String[].Value", sa.Payload_String[j].Value, sb.Payload_String[j].Value);
+            }
+        }
+    }
+
+    // UnpackerMessages
+    diff_size("", "UnpackerMessages.size", a.UnpackerMessages.size(), b.UnpackerMessages.size());
+    for(size_t i=0;i<min(a.UnpackerMessages.size(), b.UnpackerMessages.size());i++) {
+        path_push p(path, i);
+        const auto& ma = a.UnpackerMessages[i];
+        const auto& mb = b.UnpackerMessages[i];
+        const char* base = "UnpackerMessages[]";
+        diff_int   (base, "Level",   to_int(ma.Level), to_int(mb.Level));
+        diff_string(base, "Message", ma.Message,       mb.Message);
+        if(diff_size(base, "Payload.size", ma.Payload.size(), mb.Payload.size())) {
+            for(size_t j=0;j<ma.Payload.size();j++) {
+                path_push p(path, j);
+                diff_float(base, "Payload[]", ma.Payload[j], mb.Payload[j]);
+            }
+        }
+    }
+
+    // TaggerHits
+    diff_size("", "TaggerHits.size", a.TaggerHits.size(), b.TaggerHits.size());
+    for(size_t i=0;i<min(a.TaggerHits.size(), b.TaggerHits.size());i++) {
+        path_push p(path, i);
+        const auto& ta = a.TaggerHits[i];
+        const auto& tb = b.TaggerHits[i];
+        const char* base = "TaggerHits[]";
+        diff_int  (base, "Channel",      ta.Channel,      tb.Channel);
+        diff_float(base, "PhotonEnergy", ta.PhotonEnergy, tb.PhotonEnergy);
+        diff_float(base, "Time",         ta.Time,         tb.Time);
+        diff_size (base, "Electrons.size", ta.Electrons.size(), tb.Electrons.size());
+        for(size_t j=0;j<min(ta.Electrons.size(), tb.Electrons.size());j++) {
+            path_push p(path, j);
+            diff_int  (base, "Electrons[].Key",       ta.Electrons[j].Key,             tb.Electrons[j].Key);
+            diff_float(base, "Electrons[].Timing",    ta.Electrons[j].Value.Timing,    tb.Electrons[j].Value.Timing);
+            diff_float(base, "Electrons[].QDCEnergy", ta.Electrons[j].Value.QDCEnergy, tb.Electrons[j].Value.QDCEnergy);
+        }
+    }
+
+    // Trigger and Target
+    {
+        const auto& ta = a.Trigger;
+        const auto& tb = b.Trigger;
+        const char* base = "Trigger";
+        diff_float(base, "CBEnergySum",         ta.CBEnergySum,         tb.CBEnergySum);
+        diff_int  (base, "ClusterMultiplicity", ta.ClusterMultiplicity, tb.ClusterMultiplicity);
+        diff_float(base, "CBTiming",            ta.CBTiming,            tb.CBTiming);
+        diff_int  (base, "DAQEventID",          ta.DAQEventID,          tb.DAQEventID);
+        diff_size (base, "DAQErrors.size",      ta.DAQErrors.size(),    tb.DAQErrors.size());
+        for(size_t i=0;i<min(ta.DAQErrors.size(), tb.DAQErrors.size());i++) {
+            path_push p(path, i);
+            const auto& ea = ta.DAQErrors[i];
+            const auto& eb = tb.DAQErrors[i];
+            diff_int   (base, "DAQErrors[].ModuleID",    ea.ModuleID,    eb.ModuleID);
+            diff_int   (base, "DAQErrors[].ModuleIndex", ea.ModuleIndex, eb.ModuleIndex);
+            diff_int   (base, "DAQErrors[].ErrorCode",   ea.ErrorCode,   eb.ErrorCode);
+            diff_string(base, "DAQErrors[].ModuleName",  ea.ModuleName,  eb.ModuleName);
+        }
+    }
+    diff_float("Target", "Vertex.x", a.Target.Vertex.x, b.Target.Vertex.x);
+    diff_float("Target", "Vertex.y", a.Target.Vertex.y, b.Target.Vertex.y);
+    diff_float("Target", "Vertex.z", a.Target.Vertex.z, b.Target.Vertex.z);
+
+    // Clusters
+    diff_size("", "Clusters.size", a.Clusters.size(), b.Clusters.size());
+    {
+        auto it_a = a.Clusters.begin();
+        auto it_b = b.Clusters.begin();
+        for(unsigned i=0; it_a != a.Clusters.end() && it_b != b.Clusters.end(); ++it_a, ++it_b, ++i) {
+            path_push p(path, i);
+            CompareCluster("Clusters[]", *it_a, *it_b);
+        }
+    }
+
+    // Candidates
+    diff_size("", "Candidates.size", a.Candidates.size(), b.Candidates.size());
+    {
+        auto it_a = a.Candidates.begin();
+        auto it_b = b.Candidates.begin();
+        for(unsigned i=0; it_a != a.Candidates.end() && it_b != b.Candidates.end(); ++it_a, ++it_b, ++i) {
+            path_push p(path, i);
+            const TCandidate& ca = *it_a;
+            const TCandidate& cb = *it_b;
+            const char* base = "Candidates[]";
+            if(ca.Detector != cb.Detector)
+                diff_string(base, "Detector", ca.Detector, cb.Detector);
+            diff_float(base, "CaloEnergy",    ca.CaloEnergy,    cb.CaloEnergy);
+            diff_float(base, "Theta",         ca.Theta,         cb.Theta);
+            diff_float(base, "Phi",           ca.Phi,           cb.Phi);
+            diff_float(base, "Time",          ca.Time,          cb.Time);
+            diff_int  (base, "ClusterSize",   ca.ClusterSize,   cb.ClusterSize);
+            diff_float(base, "VetoEnergy",    ca.VetoEnergy,    cb.VetoEnergy);
+            diff_float(base, "TrackerEnergy", ca.TrackerEnergy, cb.TrackerEnergy);
+            diff_size (base, "Clusters.size", ca.Clusters.size(), cb.Clusters.size());
+            auto it_cl_a = ca.Clusters.begin();
+            auto it_cl_b = cb.Clusters.begin();
+            for(unsigned j=0; it_cl_a != ca.Clusters.end() && it_cl_b != cb.Clusters.end(); ++it_cl_a, ++it_cl_b, ++j) {
+                path_push p(path, j);
+                CompareCluster("Candidates[].Clusters[]", *it_cl_a, *it_cl_b);
+            }
+        }
+    }
+
+    // ParticleTree, compared flat in depth-first order
+    {
+        using node_t = pair<TParticlePtr, size_t>;
+        auto flatten = [] (const TParticleTree_t& tree) {
+            vector<node_t> nodes;
+            if(tree)
+                tree->Map_level([&nodes] (const TParticlePtr& p, size_t level) { nodes.emplace_back(p, level); });
+            return nodes;
+        };
+        const auto pa = flatten(a.ParticleTree);
+        const auto pb = flatten(b.ParticleTree);
+        if(diff_size("", "ParticleTree.size", pa.size(), pb.size())) {
+            const char* base = "ParticleTree[]";
+            for(unsigned i=0;i<pa.size();i++) {
+                path_push p(path, i);
+                diff_int(base, "Level", pa[i].second, pb[i].second);
+                if(!pa[i].first || !pb[i].first) {
+                    diff_int(base, "present", bool(pa[i].first), bool(pb[i].first));
+                    continue;
+                }
+                const TParticle& ta = *pa[i].first;
+                const TParticle& tb = *pb[i].first;
+                if(addressof(ta.Type()) != addressof(tb.Type()))
+                    diff_string(base, "Type", ta.Type().Name(), tb.Type().Name());
+                diff_float(base, "E",   ta.E,   tb.E);
+                diff_float(base, "p.x", ta.p.x, tb.p.x);
+                diff_float(base, "p.y", ta.p.y, tb.p.y);
+                diff_float(base, "p.z", ta.p.z, tb.p.z);
+            }
+        }
+    }
+
+    const bool differs = current_differs;
+    current_differs = current_differs || differed_before;
+    if(standalone)
+        return EndEvent();
+    return !differs;
+}
+
+void EventDiff::Summary_t::Merge(const Summary_t& other, unsigned maxExamples)
+{
+    Compared   += other.Compared;
+    Differing  += other.Differing;
+    OnlyFirst  += other.OnlyFirst;
+    OnlySecond += other.OnlySecond;
+    for(const auto& it : other.Fields) {
+        auto& field = Fields[it.first];
+        field.Events += it.second.Events;
+        for(const auto& example : it.second.Examples) {
+            if(field.Examples.size() >= maxExamples)
+                break;
+            field.Examples.push_back(example);
+        }
+    }
+}
+
+ostream& EventDiff::Summary_t::Print(ostream& s) const
+{
+    s << "Compared events: " << Compared << ", differing: " << Differing
+      << ", only in first: " << OnlyFirst << ", only in second: " << OnlySecond << '\n';
+    if(Fields.empty())
+        return s;
+    s << "Differing events per field:\n";
+    size_t width = 0;
+    for(const auto& it : Fields)
+        width = max(width, it.first.size());
+    for(const auto& it : Fields) {
+        s << "  " << left << setw(int(width)) << it.first << right
+          << " " << setw(12) << it.second.Events << '\n';
+        for(const auto& example : it.second.Examples)
+            s << "      " << example << '\n';
+    }
+    return s;
+}
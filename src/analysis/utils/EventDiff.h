@@ -0,0 +1,133 @@
+#pragma once
+
+#include "base/printable.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <stdexcept>
+
+namespace ant {
+
+struct TID;
+struct TEventData;
+struct TCluster;
+
+namespace analysis {
+
+namespace input {
+struct event_t;
+}
+
+namespace utils {
+
+/**
+ * @brief The EventDiff class compares events field by field
+ *
+ * Meant to validate that a changed unpacker or reconstruction still produces
+ * identical output. Each field of TEventData (down to cluster hits and particle
+ * trees) is compared, floating point values within the given tolerance, where NaN equals NaN.
+ *
+ * The summary counts per field the events with at least one difference, and keeps the
+ * first MaxExamples of them with TID, position and values. Its size does not grow with the
+ * number of compared events. Summaries of several EventDiff instances can be merged.
+ */
+class EventDiff {
+public:
+
+    struct Options_t {
+        double   AbsTolerance = 0;
+        double   RelTolerance = 0;
+        unsigned MaxExamples  = 5;
+    };
+
+    struct Field_t {
+        std::uint64_t Events = 0; // events with at least one difference in this field
+        std::vector<std::string> Examples;
+
+        template<class Archive>
+        void serialize(Archive& archive) {
+            archive(Events, Examples);
+        }
+    };
+
+    struct Summary_t : printable_traits {
+        std::uint64_t Compared   = 0;
+        std::uint64_t Differing  = 0;
+        std::uint64_t OnlyFirst  = 0;
+        std::uint64_t OnlySecond = 0;
+        std::map<std::string, Field_t> Fields;
+
+        bool Identical() const {
+            return Differing == 0 && OnlyFirst == 0 && OnlySecond == 0;
+        }
+
+        /**
+         * @brief Merge adds the other summary, which should cover later events
+         */
+        void Merge(const Summary_t& other, unsigned maxExamples);
+
+        template<class Archive>
+        void serialize(Archive& archive) {
+            archive(Compared, Differing, OnlyFirst, OnlySecond, Fields);
+        }
+
+        virtual std::ostream& Print(std::ostream& s) const override;
+    };
+
+    EventDiff();
+    explicit EventDiff(const Options_t& options_);
+
+    /**
+     * @brief Compare the reconstructed and MC true parts of two events with the same TID
+     * @return true if no difference was found
+     */
+    bool Compare(const input::event_t& a, const input::event_t& b);
+
+    /**
+     * @brief CompareData compares two TEventData, the prefix is used for the field names
+     * @return true if no difference was found
+     */
+    bool CompareData(const TEventData& a, const TEventData& b, const std::string& prefix = "Reconstructed");
+
+    void AddOnlyFirst(const TID& id);
+    void AddOnlySecond(const TID& id);
+
+    const Summary_t& GetSummary() const { return summary; }
+    const Options_t& GetOptions() const { return options; }
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+protected:
+    const Options_t options;
+    Summary_t summary;
+
+    // state while comparing one event
+    std::string prefix;
+    const TID*  current_id = nullptr;
+    bool        current_differs = false;
+    std::uint64_t current_event = 0;
+    std::vector<unsigned> path; // indices of the nested containers
+    std::map<std::string, std::uint64_t> last_event; // avoids counting one field twice per event
+
+    void BeginEvent(const TID& id);
+    bool EndEvent();
+
+    bool Equal(double a, double b) const;
+
+    // field name is base.leaf, base may be empty. Each [] in the name
+    // is replaced by the corresponding index of path in the example
+    void Report(const char* base, const char* leaf, const std::string& values);
+
+    void diff_float(const char* base, const char* leaf, double a, double b);
+    void diff_int(const char* base, const char* leaf, std::int64_t a, std::int64_t b);
+    void diff_string(const char* base, const char* leaf, const std::string& a, const std::string& b);
+    bool diff_size(const char* base, const char* leaf, std::size_t a, std::size_t b);
+
+    void CompareCluster(const char* base, const TCluster& a, const TCluster& b);
+};
+
+}}} // namespace ant::analysis::utils
@@ -37,16 +37,31 @@ ant::TParticlePtr MCSmear::Smear(const TParticlePtr& p, Uncertainties_t& sigmas)
     }
     else {
         sigmas = model->GetSigmas(*p);
+        smeared = SmearWithSigmas(p, sigmas);
+    }
 
-        const double Ek    = rng->Gaus(p->Ek(),    sigmas.sigmaEk);
-        const double Theta = rng->Gaus(p->Theta(), sigmas.sigmaTheta);
-        const double Phi   = rng->Gaus(p->Phi(),   sigmas.sigmaPhi);
+    return smeared;
+}
 
-        smeared = make_shared<TParticle>(type, Ek, Theta, Phi);
-        smeared->Candidate = p->Candidate;
-    }
+TParticlePtr MCSmear::SmearWithSigmas(const TParticlePtr& p, const Uncertainties_t& sigmas) const
+{
+    const double Ek    = rng->Gaus(p->Ek(),    sigmas.sigmaEk);
+    const double Theta = rng->Gaus(p->Theta(), sigmas.sigmaTheta);
+    const double Phi   = rng->Gaus(p->Phi(),   sigmas.sigmaPhi);
 
+    auto smeared = make_shared<TParticle>(p->Type(), Ek, Theta, Phi);
+    smeared->Candidate = p->Candidate;
+    return smeared;
+}
+
+TParticleList MCSmear::Smear(const TParticleList& particles) const
+{
+    model->GetAllSigmas(particles, batch_sigmas);
 
+    TParticleList smeared;
+    smeared.reserve(particles.size());
+    for(size_t i=0;i<particles.size();i++)
+        smeared.emplace_back(SmearWithSigmas(particles[i], batch_sigmas[i]));
     return smeared;
 }
 
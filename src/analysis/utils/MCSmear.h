@@ -25,6 +25,18 @@ public:
 
     ant::TParticlePtr  Smear(const ant::TParticlePtr& p, Uncertainties_t& sigmas) const;
 
+    /**
+     * @brief Smear all particles, looking up the uncertainties in one batch
+     * @param particles must not contain BeamTarget particles
+     */
+    ant::TParticleList Smear(const ant::TParticleList& particles) const;
+
+protected:
+    ant::TParticlePtr  SmearWithSigmas(const ant::TParticlePtr& p, const Uncertainties_t& sigmas) const;
+
+    // buffer for batch lookup
+    mutable std::vector<Uncertainties_t> batch_sigmas;
+
 
 };
 
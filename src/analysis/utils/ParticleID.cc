@@ -5,9 +5,13 @@
 #include "base/std_ext/system.h"
 #include "base/WrapTFile.h"
 #include "base/Logger.h"
+#include "base/std_ext/memory.h"
 
 #include "TCutG.h"
 
+#include <algorithm>
+#include <limits>
+
 
 using namespace std;
 using namespace ant;
@@ -27,6 +31,14 @@ TParticlePtr ParticleID::Process(const TCandidatePtr& cand) const
     return nullptr;
 }
 
+void ParticleID::IdentifyAll(const TCandidateList& cands, types_t& types) const
+{
+    types.resize(cands.size());
+    size_t i = 0;
+    for(const auto& cand : cands.get_iter())
+        types[i++] = Identify(cand);
+}
+
 std::unique_ptr<const ParticleID> ParticleID::default_particle_id = nullptr;
 
 const ParticleID& ParticleID::GetDefault()
@@ -60,20 +72,27 @@ BasicParticleID::~BasicParticleID()
 
 }
 
-bool TestCut(const std::shared_ptr<TCutG>& cut, const double& x, const double& y) {
+template<typename CutPtr>
+bool TestCut(const CutPtr& cut, const double& x, const double& y) {
     return (cut) && cut->IsInside(x,y);
 }
 
-
-
-const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr& cand) const
+// the identification logic, shared by basic and compiled cuts
+template<typename CutPtr>
+const ParticleTypeDatabase::Type* IdentifyWithCuts(
+        const TCandidate& cand,
+        const CutPtr& dEE_proton,
+        const CutPtr& dEE_pion,
+        const CutPtr& dEE_electron,
+        const CutPtr& tof,
+        const CutPtr& size)
 {
-    const bool hadronic =    TestCut(tof,  cand->CaloEnergy, cand->Time)
-                  || TestCut(size, cand->CaloEnergy, cand->ClusterSize);
+    const bool hadronic =    TestCut(tof,  cand.CaloEnergy, cand.Time)
+                  || TestCut(size, cand.CaloEnergy, cand.ClusterSize);
 
     const bool hadronic_enabled = (tof) || (size);
 
-    const bool charged = cand->VetoEnergy > 0.0;
+    const bool charged = cand.VetoEnergy > 0.0;
 
 
 
@@ -89,19 +108,19 @@ const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr&
 
         if(
            (hadronic_enabled && hadronic)
-           || (TestCut(dEE_proton, cand->CaloEnergy, cand->VetoEnergy))
+           || (TestCut(dEE_proton, cand.CaloEnergy, cand.VetoEnergy))
            ) {
             return addressof(ParticleTypeDatabase::Proton);
         }
 
         if(
-           TestCut(dEE_pion, cand->CaloEnergy, cand->VetoEnergy)
+           TestCut(dEE_pion, cand.CaloEnergy, cand.VetoEnergy)
            ) {
             return addressof(ParticleTypeDatabase::PiCharged);
         }
 
         if(
-           TestCut(dEE_electron, cand->CaloEnergy, cand->VetoEnergy)
+           TestCut(dEE_electron, cand.CaloEnergy, cand.VetoEnergy)
            ) {
             return addressof(ParticleTypeDatabase::eCharged);
         }
@@ -110,6 +129,104 @@ const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr&
     return nullptr;
 }
 
+const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr& cand) const
+{
+    return IdentifyWithCuts(*cand, dEE_proton, dEE_pion, dEE_electron, tof, size);
+}
+
+CompiledCutG::CompiledCutG(const TCutG& cut, unsigned nSlabs_) :
+    nSlabs(nSlabs_ > 0 ? nSlabs_ : 1)
+{
+    const int np = cut.GetN();
+    const double* x = cut.GetX();
+    const double* y = cut.GetY();
+
+    xmin = ymin =  numeric_limits<double>::infinity();
+    xmax = ymax = -numeric_limits<double>::infinity();
+    for(int i=0;i<np;i++) {
+        xmin = std::min(xmin, x[i]);
+        xmax = std::max(xmax, x[i]);
+        ymin = std::min(ymin, y[i]);
+        ymax = std::max(ymax, y[i]);
+    }
+
+    inv_dy = ymax > ymin ? nSlabs/(ymax-ymin) : 0;
+
+    // sort the edges into y slabs, an edge is put into each slab it touches,
+    // with one extra slab on each side to be safe against rounding,
+    // since IsInside evaluates the full crossing condition anyway
+    vector<vector<edge_t>> slabs(nSlabs);
+    for(int i=0, j=np-1; i<np; j=i++) {
+        const edge_t edge{x[i], y[i], x[j], y[j]};
+        const double lo = std::min(y[i], y[j]);
+        const double hi = std::max(y[i], y[j]);
+        const int k_lo = std::max(0, static_cast<int>((lo-ymin)*inv_dy) - 1);
+        const int k_hi = std::min(static_cast<int>(nSlabs)-1, static_cast<int>((hi-ymin)*inv_dy) + 1);
+        for(int k=k_lo;k<=k_hi;k++)
+            slabs[k].push_back(edge);
+    }
+
+    slab_offsets.reserve(nSlabs+1);
+    for(const auto& slab : slabs) {
+        slab_offsets.push_back(edges.size());
+        edges.insert(edges.end(), slab.begin(), slab.end());
+    }
+    slab_offsets.push_back(edges.size());
+}
+
+bool CompiledCutG::IsInside(double xp, double yp) const noexcept
+{
+    // points outside the bounding box cross an even number of edges,
+    // also NaN ends up here
+    if(!(xp >= xmin && xp <= xmax && yp >= ymin && yp <= ymax))
+        return false;
+
+    const unsigned k = std::min(nSlabs-1, static_cast<unsigned>((yp-ymin)*inv_dy));
+
+    // same crossing test as TMath::IsInside used by TCutG::IsInside
+    bool oddNodes = false;
+    for(unsigned e=slab_offsets[k]; e<slab_offsets[k+1]; e++) {
+        const edge_t& edge = edges[e];
+        if((edge.yi<yp && edge.yj>=yp) || (edge.yj<yp && edge.yi>=yp)) {
+            if(edge.xi+(yp-edge.yi)/(edge.yj-edge.yi)*(edge.xj-edge.xi)<xp) {
+                oddNodes = !oddNodes;
+            }
+        }
+    }
+    return oddNodes;
+}
+
+namespace {
+
+CompiledParticleID::cut_ptr_t compile(const std::shared_ptr<TCutG>& cut) {
+    return cut ? std_ext::make_unique<CompiledCutG>(*cut) : nullptr;
+}
+
+}
+
+CompiledParticleID::CompiledParticleID(const BasicParticleID& basic) :
+    dEE_proton(compile(basic.dEE_proton)),
+    dEE_pion(compile(basic.dEE_pion)),
+    dEE_electron(compile(basic.dEE_electron)),
+    tof(compile(basic.tof)),
+    size(compile(basic.size))
+{}
+
+CompiledParticleID::~CompiledParticleID()
+{
+
+}
+
+const ParticleTypeDatabase::Type* CompiledParticleID::Identify(const TCandidatePtr& cand) const
+{
+    return Identify(*cand);
+}
+
+const ParticleTypeDatabase::Type* CompiledParticleID::Identify(const TCandidate& cand) const
+{
+    return IdentifyWithCuts(cand, dEE_proton, dEE_pion, dEE_electron, tof, size);
+}
+
 
 
 
@@ -165,4 +282,39 @@ void CBTAPSBasicParticleID::LoadFrom(WrapTFile& file)
         taps.size           = file.GetSharedClone<TCutG>("taps_CluserSize");
 }
 
+CBTAPSCompiledParticleID::CBTAPSCompiledParticleID(const string& pidcutsdir) :
+    CBTAPSBasicParticleID(pidcutsdir),
+    cb_compiled(cb),
+    taps_compiled(taps)
+{
 
+}
+
+CBTAPSCompiledParticleID::~CBTAPSCompiledParticleID()
+{
+
+}
+
+const ParticleTypeDatabase::Type* CBTAPSCompiledParticleID::Identify(const TCandidate& cand) const
+{
+    if(cand.Detector & Detector_t::Any_t::CB_Apparatus) {
+        return cb_compiled.Identify(cand);
+    } else if(cand.Detector & Detector_t::Any_t::TAPS_Apparatus) {
+        return taps_compiled.Identify(cand);
+    }
+
+    return nullptr;
+}
+
+const ParticleTypeDatabase::Type* CBTAPSCompiledParticleID::Identify(const TCandidatePtr& cand) const
+{
+    return Identify(*cand);
+}
+
+void CBTAPSCompiledParticleID::IdentifyAll(const TCandidateList& cands, types_t& types) const
+{
+    types.resize(cands.size());
+    size_t i = 0;
+    for(const TCandidate& cand : cands)
+        types[i++] = Identify(cand);
+}
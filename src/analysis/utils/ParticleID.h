@@ -4,6 +4,7 @@
 #include "base/ParticleType.h"
 
 #include <memory>
+#include <vector>
 
 class TCutG;
 
@@ -22,6 +23,14 @@ public:
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const =0;
     virtual TParticlePtr Process(const TCandidatePtr& cand) const;
 
+    using types_t = std::vector<const ParticleTypeDatabase::Type*>;
+    /**
+     * @brief IdentifyAll is the batch version of Identify
+     * @param cands the candidates
+     * @param types resized to cands, nullptr if not identified
+     */
+    virtual void IdentifyAll(const TCandidateList& cands, types_t& types) const;
+
     static const ParticleID& GetDefault();
     static void SetDefault(std::unique_ptr<const ParticleID> id);
 private:
@@ -55,6 +64,55 @@ public:
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
 };
 
+/**
+ * @brief The CompiledCutG class is an edge table of a TCutG polygon.
+ * IsInside gives identical results to TCutG::IsInside, but rejects points outside
+ * the bounding box first and only tests the edges in the y slab of the point.
+ */
+class CompiledCutG {
+public:
+    explicit CompiledCutG(const TCutG& cut, unsigned nSlabs = 32);
+
+    bool IsInside(double x, double y) const noexcept;
+
+protected:
+    struct edge_t {
+        double xi, yi, xj, yj;
+    };
+
+    double xmin, xmax;
+    double ymin, ymax;
+    double inv_dy;
+    unsigned nSlabs;
+
+    // edges of slab k are in [slab_offsets[k], slab_offsets[k+1])
+    std::vector<edge_t>   edges;
+    std::vector<unsigned> slab_offsets;
+};
+
+/**
+ * @brief The CompiledParticleID class uses CompiledCutG copies of the cuts
+ * of a BasicParticleID, the identification logic is the same.
+ */
+class CompiledParticleID: public ParticleID {
+public:
+    CompiledParticleID(const BasicParticleID& basic);
+    virtual ~CompiledParticleID();
+
+    using cut_ptr_t = std::unique_ptr<const CompiledCutG>;
+
+    cut_ptr_t dEE_proton;
+    cut_ptr_t dEE_pion;
+    cut_ptr_t dEE_electron;
+
+    cut_ptr_t tof;
+
+    cut_ptr_t size;
+
+    virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
+    const ParticleTypeDatabase::Type* Identify(const TCandidate& cand) const;
+};
+
 class CBTAPSBasicParticleID: public ParticleID {
 protected:
     BasicParticleID cb;
@@ -68,6 +126,25 @@ public:
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
 };
 
+/**
+ * @brief The CBTAPSCompiledParticleID class loads the same cuts as CBTAPSBasicParticleID,
+ * but identifies with compiled cuts
+ */
+class CBTAPSCompiledParticleID: public CBTAPSBasicParticleID {
+protected:
+    CompiledParticleID cb_compiled;
+    CompiledParticleID taps_compiled;
+
+    const ParticleTypeDatabase::Type* Identify(const TCandidate& cand) const;
+
+public:
+    CBTAPSCompiledParticleID(const std::string& pidcutsdir);
+    virtual ~CBTAPSCompiledParticleID();
+
+    virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
+    virtual void IdentifyAll(const TCandidateList& cands, types_t& types) const override;
+};
+
 }
 }
 }
@@ -33,7 +33,9 @@ double UncertaintyModel::GetBeamEnergySigma(double photon_energy) const
     return 1;
 }
 
-
-
-
-
+void UncertaintyModel::GetAllSigmas(const TParticleList& particles, std::vector<Uncertainties_t>& sigmas) const
+{
+    sigmas.resize(particles.size());
+    for(size_t i=0;i<particles.size();i++)
+        sigmas[i] = GetSigmas(*particles[i]);
+}
@@ -47,6 +47,12 @@ public:
     UncertaintyModel();
     virtual ~UncertaintyModel();
     virtual Uncertainties_t GetSigmas(const TParticle& particle) const =0;
+    /**
+     * @brief GetAllSigmas is the batch version of GetSigmas
+     * @param particles list of particles
+     * @param sigmas resized to particles, i-th element are the uncertainties of i-th particle
+     */
+    virtual void GetAllSigmas(const TParticleList& particles, std::vector<Uncertainties_t>& sigmas) const;
     virtual double GetBeamEnergySigma(double photon_energy) const;
     struct Exception : std::runtime_error {
         using std::runtime_error::runtime_error;
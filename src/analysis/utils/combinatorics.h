@@ -1,8 +1,13 @@
 #pragma once
 
 #include "base/std_ext/vector.h"
+#include "base/vec/LorentzVec.h"
 
 #include <vector>
+#include <map>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
 
 namespace ant {
 namespace analysis {
@@ -33,36 +38,31 @@ protected:
 
     bool nextlevel( index_type i ) {
 
-        if(indices.at(i) >= data.size() - (indices.size() - i)) {
+        if(indices[i] >= data.size() - (indices.size() - i)) {
             if( i!=0 && nextlevel(i-1) ) {
-                indices.at(i) = indices.at(i-1) +1;
+                indices[i] = indices[i-1] +1;
                 return true;
             } else
                 return false;
         } else {
-            indices.at(i)++;
+            indices[i]++;
             return true;
         }
     }
 
     void calc_not_indices() {
+        // indices are sorted, so one merge-like pass suffices
         not_indices.resize(0);
+        auto it_index = indices.begin();
         for(index_type i=0;i<n(); ++i) {
-            if(!std_ext::contains(indices, i))
+            if(it_index != indices.end() && *it_index == i)
+                ++it_index;
+            else
                 not_indices.emplace_back(i);
         }
     }
 
-public:
-    typedef T value_type;
-
-    /**
-     * @brief KofNvector
-     * @param _data The std::vector to draw from
-     * @param k number of elemets to draw each time
-     */
-    KofNvector( const std::vector<T>& _data, index_type k): data(_data), done(false) {
-
+    void init(index_type k) {
         if(k>data.size()) {
             k=0;
             done=true;
@@ -70,14 +70,33 @@ public:
 
         indices.resize(k);
 
-
         for(index_type i=0;i<k; ++i) {
-            indices.at(i) = i;
+            indices[i] = i;
         }
+        not_indices.reserve(data.size());
         calc_not_indices();
     }
 
-    /// \todo make a move constructor
+public:
+    typedef T value_type;
+
+    /**
+     * @brief KofNvector
+     * @param _data The std::vector to draw from
+     * @param k number of elemets to draw each time
+     */
+    KofNvector( const std::vector<T>& _data, index_type k): data(_data), done(false) {
+        init(k);
+    }
+
+    /**
+     * @brief KofNvector takes over the given std::vector, avoiding the copy
+     * @param _data The std::vector to draw from
+     * @param k number of elemets to draw each time
+     */
+    KofNvector( std::vector<T>&& _data, index_type k): data(std::move(_data)), done(false) {
+        init(k);
+    }
 
     /**
      * @brief Access the ith element of the currently drawn combination
@@ -123,7 +142,7 @@ public:
 
         bool operator!=(const const_iterator& rhs) {return index!=rhs.index;}
 
-        const T& operator*() const { return v.data.at(*index); }
+        const T& operator*() const { return v.data[*index]; }
 
         typedef T value_type;
     };
@@ -160,4 +179,221 @@ KofNvector<T> makeCombination( const std::vector<T>& data, const unsigned int k)
     return KofNvector<T>(data,k);
 }
 
+template <typename T>
+KofNvector<T> makeCombination( std::vector<T>&& data, const unsigned int k) {
+    return KofNvector<T>(std::move(data),k);
+}
+
+/**
+ * @brief KofNtable class: All combinations of drawing k out of n elements, enumerated once.
+ *
+ * Combinations are in the same order as generated by KofNvector.
+ * The indices are stored column-wise, i.e. the i-th index of all combinations
+ * is contiguous in memory, which makes looping over all combinations vectorizable.
+ * Use KofNtable::Get to obtain a cached instance, such that enumerating
+ * the combinations of frequently occuring multiplicities does not allocate.
+ */
+class KofNtable {
+public:
+    using index_type = std::uint32_t;
+    using mask_type = std::uint32_t;
+
+    KofNtable(unsigned n, unsigned k) : n_(n), k_(k) {
+        if(k>n)
+            return;
+
+        // same stepping as KofNvector, but into a row-wise scratch buffer
+        std::vector<index_type> current(k);
+        for(unsigned i=0;i<k;i++)
+            current[i] = i;
+        std::vector<index_type> rows;
+        while(true) {
+            rows.insert(rows.end(), current.begin(), current.end());
+            nCombinations++;
+            int i = int(k)-1;
+            while(i>=0 && current[i] >= n - k + unsigned(i))
+                i--;
+            if(i<0)
+                break;
+            current[i]++;
+            for(unsigned j=unsigned(i)+1;j<k;j++)
+                current[j] = current[j-1]+1;
+        }
+
+        indices.resize(rows.size());
+        for(std::size_t c=0;c<nCombinations;c++)
+            for(unsigned i=0;i<k;i++)
+                indices[i*nCombinations+c] = rows[c*k+i];
+
+        if(n <= 8*sizeof(mask_type)) {
+            masks.resize(nCombinations, 0);
+            for(std::size_t c=0;c<nCombinations;c++)
+                for(unsigned i=0;i<k;i++)
+                    masks[c] |= mask_type(1) << Index(c,i);
+        }
+    }
+
+    unsigned n() const noexcept { return n_; }
+    unsigned k() const noexcept { return k_; }
+
+    /**
+     * @brief size
+     * @return number of combinations
+     */
+    std::size_t size() const noexcept { return nCombinations; }
+
+    /**
+     * @brief Index of the i-th element in the c-th combination
+     */
+    index_type Index(std::size_t c, unsigned i) const noexcept { return indices[i*nCombinations+c]; }
+
+    /**
+     * @brief Column of the i-th element of all combinations
+     */
+    const index_type* Column(unsigned i) const noexcept { return &indices[i*nCombinations]; }
+
+    /**
+     * @brief Masks has bit j set in the c-th entry if element j is part of combination c
+     * @return list of masks, empty if n exceeds the number of bits in mask_type
+     */
+    const std::vector<mask_type>& Masks() const noexcept { return masks; }
+
+    /**
+     * @brief Get a cached table, not thread-safe
+     */
+    static const KofNtable& Get(unsigned n, unsigned k) {
+        static std::map<std::pair<unsigned, unsigned>, KofNtable> tables;
+        const auto key = std::make_pair(n, k);
+        auto it = tables.find(key);
+        if(it == tables.end())
+            it = tables.emplace(key, KofNtable(n, k)).first;
+        return it->second;
+    }
+
+protected:
+    unsigned n_;
+    unsigned k_;
+    std::size_t nCombinations = 0;
+    std::vector<index_type> indices;
+    std::vector<mask_type>  masks;
+};
+
+/**
+ * @brief LorentzVecArrays stores a list of four-vectors as structure of arrays
+ */
+struct LorentzVecArrays {
+    std::vector<double> E;
+    std::vector<double> px;
+    std::vector<double> py;
+    std::vector<double> pz;
+
+    std::size_t size() const noexcept { return E.size(); }
+
+    void clear() noexcept {
+        E.clear();
+        px.clear();
+        py.clear();
+        pz.clear();
+    }
+
+    void push_back(const LorentzVec& v) {
+        E.push_back(v.E);
+        px.push_back(v.p.x);
+        py.push_back(v.p.y);
+        pz.push_back(v.p.z);
+    }
+
+    /**
+     * @brief Assign from a list of pointers to four-vectors, such as TParticleList
+     */
+    template<typename PtrContainer>
+    void Assign(const PtrContainer& ptrs) {
+        clear();
+        for(const auto& ptr : ptrs)
+            push_back(*ptr);
+    }
+
+    void Assign(const std::vector<LorentzVec>& vecs) {
+        clear();
+        for(const auto& v : vecs)
+            push_back(v);
+    }
+};
+
+/**
+ * @brief IMCombinations calculates the invariant masses of all k-of-n combinations of four-vectors
+ *
+ * The four-vectors are summed in the same order as KofNvector iterates over the elements,
+ * so the masses are identical to summing up LorentzVec's for each combination.
+ * All buffers are kept between calls, so re-using an instance does not allocate
+ * once the largest multiplicity has been seen.
+ */
+class IMCombinations {
+public:
+
+    /**
+     * @brief Calc the invariant masses of all combinations of k elements of the given list
+     * @param particles list of pointers to four-vectors, or list of LorentzVec
+     * @param k number of elements to draw
+     * @return invariant masses, ordered like the combinations in Table()
+     */
+    template<typename Container>
+    const std::vector<double>& Calc(const Container& particles, unsigned k) {
+        vecs.Assign(particles);
+        return Calc(k);
+    }
+
+    /**
+     * @brief Calc on the four-vectors already present in Vecs()
+     */
+    const std::vector<double>& Calc(unsigned k) {
+        table = std::addressof(KofNtable::Get(unsigned(vecs.size()), k));
+        const auto nC = table->size();
+
+        sumE.assign(nC, 0.0);
+        sumX.assign(nC, 0.0);
+        sumY.assign(nC, 0.0);
+        sumZ.assign(nC, 0.0);
+
+        for(unsigned i=0;i<k && nC>0;i++) {
+            const auto col = table->Column(i);
+            for(std::size_t c=0;c<nC;c++) {
+                const auto j = col[c];
+                sumE[c] += vecs.E[j];
+                sumX[c] += vecs.px[j];
+                sumY[c] += vecs.py[j];
+                sumZ[c] += vecs.pz[j];
+            }
+        }
+
+        ims.resize(nC);
+        for(std::size_t c=0;c<nC;c++) {
+            // same as LorentzVec::M()
+            const double mm = sumE[c]*sumE[c] - (sumX[c]*sumX[c]+sumY[c]*sumY[c]+sumZ[c]*sumZ[c]);
+            ims[c] = mm < 0.0 ? -std::sqrt(-mm) : std::sqrt(mm);
+        }
+        return ims;
+    }
+
+    LorentzVecArrays& Vecs() noexcept { return vecs; }
+
+    /**
+     * @brief Table of the last Calc() call, maps the masses back to the combinations
+     */
+    const KofNtable& Table() const {
+        if(!table)
+            throw std::logic_error("IMCombinations::Table() called before Calc()");
+        return *table;
+    }
+
+protected:
+    LorentzVecArrays vecs;
+    const KofNtable* table = nullptr;
+    std::vector<double> sumE;
+    std::vector<double> sumX;
+    std::vector<double> sumY;
+    std::vector<double> sumZ;
+    std::vector<double> ims;
+};
+
 }}} // namespace ant::analysis::utils
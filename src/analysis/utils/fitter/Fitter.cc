@@ -95,9 +95,14 @@ std::vector<double> Fitter::FitParticle::GetPulls() const
 
 void Fitter::FitParticle::Set(const TParticlePtr& p,
                               const UncertaintyModel& uncertainty)
+{
+    Set(p, uncertainty.GetSigmas(*p));
+}
+
+void Fitter::FitParticle::Set(const TParticlePtr& p,
+                              const Uncertainties_t& sigmas)
 {
     Particle = p;
-    const auto& sigmas = uncertainty.GetSigmas(*p);
 
     if(!p->Candidate)
         throw Exception("Need particle with candidate for fitting");
@@ -64,6 +64,7 @@ public:
         friend class TreeFitter;
 
         void Set(const TParticlePtr& p, const UncertaintyModel& uncertainty);
+        void Set(const TParticlePtr& p, const Uncertainties_t& sigmas);
 
         const std::string Name;
         const std::shared_ptr<const FitVariable> Z_Vertex;
@@ -179,18 +179,42 @@ APLCON::Result_t KinFitter::DoFit(double ebeam, const TParticlePtr& proton, cons
     return aplcon->DoFit();
 }
 
+void KinFitter::DoFits(const std::vector<double>& ebeams,
+                       const TParticlePtr& proton, const TParticleList& photons,
+                       beam_fit_callback_t callback)
+{
+    for(unsigned i=0;i<ebeams.size();i++) {
+        if(i==0)
+            PrepareFit(ebeams[i], proton, photons);
+        else
+            ResetFitParticles(ebeams[i]);
+        if(!callback(i, aplcon->DoFit()))
+            break;
+    }
+}
+
 void KinFitter::PrepareFit(double ebeam, const TParticlePtr& proton, const TParticleList& photons)
 {
     if(Photons.size() != photons.size())
         throw Exception("Given number of photons does not match configured fitter");
 
-    BeamE->SetValueSigma(ebeam, uncertainty->GetBeamEnergySigma(ebeam));
+    proton_sigmas = uncertainty->GetSigmas(*proton);
+
+    // look up the photon uncertainties in one go
+    uncertainty->GetAllSigmas(photons, photon_sigmas);
+
+    SetFitParticles(ebeam, proton, proton_sigmas, photons, photon_sigmas);
+}
 
-    Proton->Set(proton, *uncertainty);
+void KinFitter::SetFitParticles(double ebeam,
+                                const TParticlePtr& proton, const Uncertainties_t& sigmas_proton,
+                                const TParticleList& photons, const std::vector<Uncertainties_t>& sigmas_photons)
+{
+    Proton->Set(proton, sigmas_proton);
 
-    LorentzVec photon_sum; // for proton's missing_E calculation later
+    photon_sum = LorentzVec{{0,0,0},0};
     for ( unsigned i = 0 ; i < Photons.size() ; ++ i) {
-        Photons[i]->Set(photons[i], *uncertainty);
+        Photons[i]->Set(photons[i], sigmas_photons[i]);
         photon_sum += *photons[i];
     }
 
@@ -201,6 +225,35 @@ void KinFitter::PrepareFit(double ebeam, const TParticlePtr& proton, const TPart
         Z_Vertex->Sigma = Z_Vertex->Sigma_before;
     }
 
+    SetBeamE(ebeam);
+}
+
+void KinFitter::ResetFitParticles(double ebeam)
+{
+    // the fit overwrites the linked values and sigmas,
+    // so go back to what was set before
+    auto reset = [] (FitParticle& p) {
+        for(auto& v : p.Vars) {
+            v.Value = v.Value_before;
+            v.Sigma = v.Sigma_before;
+        }
+    };
+    reset(*Proton);
+    for(auto& photon : Photons)
+        reset(*photon);
+
+    if(Z_Vertex) {
+        Z_Vertex->Value = 0;
+        Z_Vertex->Sigma = Z_Vertex->Sigma_before;
+    }
+
+    SetBeamE(ebeam);
+}
+
+void KinFitter::SetBeamE(double ebeam)
+{
+    BeamE->SetValueSigma(ebeam, uncertainty->GetBeamEnergySigma(ebeam));
+
     // only set Proton Ek to missing energy if unmeasured
     auto& Var_Ek = Proton->Vars[0];
     if(Var_Ek.Sigma == 0) {
@@ -210,7 +263,6 @@ void KinFitter::PrepareFit(double ebeam, const TParticlePtr& proton, const TPart
         const double missing_E = sqrt(sqr(missing.P()) + sqr(M)) - M;
         Var_Ek.SetValueSigma(missing_E, Var_Ek.Sigma);
     }
-
 }
 
 LorentzVec KinFitter::MakeBeamLorentzVec(double BeamE)
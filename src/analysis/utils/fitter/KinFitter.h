@@ -2,6 +2,8 @@
 
 #include "Fitter.h"
 
+#include <functional>
+
 namespace ant {
 namespace analysis {
 namespace utils {
@@ -59,12 +61,44 @@ public:
 
     APLCON::Result_t DoFit(double ebeam, const TParticlePtr& proton, const TParticleList& photons);
 
+    /**
+     * @brief beam_fit_callback_t is called after each fit of DoFits,
+     * the fitted values can be obtained from the fitter inside the callback
+     * @param i index into the given beam energies
+     * @param result the fit result for that beam energy
+     * @return false to stop fitting the remaining beam energies
+     */
+    using beam_fit_callback_t = std::function<bool(unsigned i, const APLCON::Result_t& result)>;
+
+    /**
+     * @brief DoFits fits the same proton and photons for each given beam energy,
+     * for example the photon energies of all tagger hits in the event.
+     * The uncertainties are only looked up once, as only the beam energy changes between the fits.
+     * The results are identical to calling DoFit for each beam energy.
+     * @param ebeams beam energies to be fitted one after another
+     * @param proton
+     * @param photons
+     * @param callback see beam_fit_callback_t, for example return false once the chi2 is good enough
+     */
+    void DoFits(const std::vector<double>& ebeams,
+                const TParticlePtr& proton, const TParticleList& photons,
+                beam_fit_callback_t callback);
+
 protected:
 
     void PrepareFit(double ebeam,
                     const TParticlePtr& proton,
                     const TParticleList& photons);
 
+    // sets the fit particles with already known uncertainties,
+    // sigmas_photons must be ordered like the given photons
+    void SetFitParticles(double ebeam,
+                         const TParticlePtr& proton, const Uncertainties_t& sigmas_proton,
+                         const TParticleList& photons, const std::vector<Uncertainties_t>& sigmas_photons);
+
+    // restores the values before the last fit and sets the new beam energy
+    void ResetFitParticles(double ebeam);
+
     struct BeamE_t : FitVariable {
         const std::string Name = "Beam";
     };
@@ -82,6 +116,15 @@ protected:
     std::unique_ptr<BeamE_t>    BeamE;
     std::shared_ptr<Z_Vertex_t> Z_Vertex;
 
+    // buffer for the uncertainty lookup
+    std::vector<Uncertainties_t> photon_sigmas;
+    Uncertainties_t proton_sigmas;
+
+    // sum of the unfitted photons, for the proton's missing energy
+    LorentzVec photon_sum;
+
+    void SetBeamE(double ebeam);
+
     static LorentzVec MakeBeamLorentzVec(double BeamE);
 
 };
@@ -148,8 +148,28 @@ void TreeFitter::PrepareFits(double ebeam,
     // prepare the underlying kinematic fit
     // this may also set the proton's kinetic energy to missing E
     // do some more checks
+    // the looked up uncertainties are reused for each iteration
     KinFitter::PrepareFit(ebeam, proton, photons);
+    fit_photons = photons;
 
+    MakeIterations();
+}
+
+void TreeFitter::PrepareFits(double ebeam)
+{
+    if(!Proton->Particle)
+        throw Exception("PrepareFits with particles must be called before");
+
+    // the iterations use this beam energy, see PrepareFit
+    BeamE->SetValueSigma(ebeam, uncertainty->GetBeamEnergySigma(ebeam));
+
+    // the iteration filter may depend on the beam energy via the proton,
+    // so the iterations are made again
+    MakeIterations();
+}
+
+void TreeFitter::MakeIterations()
+{
     // iterations should normally be empty at this point,
     // but the user might call PrepareFits multiple times before running NextFit
     // (for whatever reason...)
@@ -162,7 +182,7 @@ void TreeFitter::PrepareFits(double ebeam,
 
         for(unsigned i=0;i<Photons.size();i++) {
             const auto perm_idx = current_perm.at(i);
-            it.Photons.emplace_back(photons.at(perm_idx), perm_idx);
+            it.Photons.emplace_back(fit_photons.at(perm_idx), perm_idx);
         }
     }
 
@@ -207,14 +227,18 @@ void TreeFitter::PrepareFit(const TreeFitter::iteration_t& it)
     // gather the photons (in the right permuation!)
     // for the KinFitter, which actually sets the FitParticles in this order!
     TParticleList photons;
+    iteration_sigmas.clear();
     for(unsigned i=0; i<Photons.size(); i++) {
         const auto& p = it.Photons.at(i);
         node_t& photon_leave = tree_leaves[i+i_leave_offset]->Get();
         photon_leave.PhotonLeaveIndex = p.LeaveIndex;
         photons.emplace_back(p.Particle);
+        iteration_sigmas.emplace_back(photon_sigmas[p.LeaveIndex]);
     }
 
-    KinFitter::PrepareFit(BeamE->Value_before, Proton->Particle, photons);
+    KinFitter::SetFitParticles(BeamE->Value_before,
+                               Proton->Particle, proton_sigmas,
+                               photons, iteration_sigmas);
 }
 
 bool TreeFitter::NextFit(APLCON::Result_t& fit_result)
@@ -63,6 +63,15 @@ public:
                      const TParticlePtr& proton,
                      const TParticleList& photons);
 
+    /**
+     * @brief PrepareFits prepares the fits again with another beam energy,
+     * but the same proton and photons as given to the last full PrepareFits call.
+     * The uncertainties are not looked up again,
+     * so use this when looping over the tagger hits of one event.
+     * @param ebeam
+     */
+    void PrepareFits(double ebeam);
+
     using iteration_filter_t = std::function<double()>;
     /**
      * @brief SetIterationFilter
@@ -107,6 +116,7 @@ protected:
 
     // force usage of "PrepareFits(...)" and "while(NextFit()) {}" interface
     using KinFitter::DoFit;
+    using KinFitter::DoFits;
 
     static tree_t MakeTree(ParticleTypeTree ptree);
     static unsigned CountGammas(ParticleTypeTree ptree);
@@ -142,6 +152,12 @@ protected:
 
     std::list<iteration_t> iterations;
 
+    // photons as given to PrepareFits, in the order of photon_sigmas
+    TParticleList fit_photons;
+    // buffer for the permuted uncertainties
+    std::vector<Uncertainties_t> iteration_sigmas;
+
+    void MakeIterations();
     void PrepareFit(const iteration_t& it);
 
     unsigned           max_iterations = 0; // 0 means no filtering
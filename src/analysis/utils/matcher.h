@@ -61,41 +61,64 @@ std::list< scored_match<typename List1::value_type, typename List2::value_type>
     typedef typename List2::value_type T2;
     typedef std::list< scored_match<T1, T2> > scorelist;
 
-
-    scorelist scores;
-
-    // build pairs and calculate scores
+    // work on flat arrays of indices,
+    // the elements themselves are only copied for the final matches
+    std::vector<const T1*> elements1;
+    std::vector<const T2*> elements2;
     for( const auto& i : list1 )
-        for( const auto& j : list2 ) {
-            const double score = f(i,j);
-            if( score_window.Contains(score)) {
-                scored_match<T1,T2> s = {score,i,j};
-                scores.emplace_back(s);
-            }
+        elements1.push_back(std::addressof(i));
+    for( const auto& j : list2 )
+        elements2.push_back(std::addressof(j));
+
+    struct scored_index_t {
+        double score;
+        unsigned i;
+        unsigned j;
+    };
+    std::vector<scored_index_t> scores;
+    scores.reserve(elements1.size()*elements2.size());
+
+    // build pairs and calculate scores,
+    // prune everything outside the window right away
+    for( unsigned i=0; i<elements1.size(); ++i )
+        for( unsigned j=0; j<elements2.size(); ++j ) {
+            const double score = f(*elements1[i], *elements2[j]);
+            if( score_window.Contains(score))
+                scores.push_back({score, i, j});
         }
 
-    scores.sort();
+    // stable sorting keeps pairs with equal scores in the order they were built
+    std::stable_sort(scores.begin(), scores.end(),
+                     [] (const scored_index_t& a, const scored_index_t& b) { return a.score < b.score; });
 
-    // find best matching pairs
-    auto i = scores.begin();
-    while(  i != scores.end() ) {
+    // greedily take the best matching pairs,
+    // skipping all pairs which include an already matched element.
+    // Elements are compared by value, so equal elements are matched only once
+    std::vector<bool> used1(elements1.size(), false);
+    std::vector<bool> used2(elements2.size(), false);
 
-        auto j = i;
-        ++j;
+    scorelist matches;
 
-        //remove all matches that include one of the two just matched particles
-        while( j!=scores.end() ) {
+    for( const auto& s : scores ) {
+        if( used1[s.i] || used2[s.j] )
+            continue;
 
-            if( j->a == i->a || j->b == i->b)
-                j = scores.erase(j);
-            else
-                ++j;
-        }
+        const T1& a = *elements1[s.i];
+        const T2& b = *elements2[s.j];
+        matches.emplace_back(scored_match<T1,T2>{s.score, a, b});
 
-        ++i;
+        for( unsigned i=0; i<elements1.size(); ++i )
+            if( *elements1[i] == a )
+                used1[i] = true;
+        for( unsigned j=0; j<elements2.size(); ++j )
+            if( *elements2[j] == b )
+                used2[j] = true;
+
+        if( matches.size() == std::min(elements1.size(), elements2.size()) )
+            break;
     }
 
-    return scores;
+    return matches;
 }
 
 template <typename T1, typename T2>
@@ -135,7 +158,8 @@ std::vector<matchpair>match2(const List1& list1,
                const List2& list2,
                MatchFunction f)
 {
-    std::list<matchpair> pairs;
+    std::vector<matchpair> pairs;
+    pairs.reserve(list1.size()*list2.size());
 
     for(size_t i=0; i<list1.size(); ++i) {
         for(size_t j=0; j<list2.size(); ++j) {
@@ -158,26 +182,21 @@ std::vector<matchpair>match2(const List1& list1,
         }
     }
 
-    pairs.sort();
-
-    {
+    std::stable_sort(pairs.begin(), pairs.end());
 
-        while(!pairs.empty()) {
-            auto i = pairs.begin();
+    // greedily take the best pairs, skipping pairs with already matched indices
+    std::vector<bool> used_a(list1.size(), false);
+    std::vector<bool> used_b(list2.size(), false);
 
-            auto& b = bestlist.at(i->a);
-            b = *i;
-
-            b.matched = true;
+    for(const auto& m : pairs) {
+        if(used_a[m.a] || used_b[m.b])
+            continue;
+        used_a[m.a] = true;
+        used_b[m.b] = true;
 
-            while(i!=pairs.end()) {
-                if(i->a == b.a || i->b == b.b) {
-                    i = pairs.erase(i);
-                } else {
-                    ++i;
-                }
-            }
-        }
+        auto& b = bestlist.at(m.a);
+        b = m;
+        b.matched = true;
     }
 
     return bestlist;
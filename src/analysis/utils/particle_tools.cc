@@ -60,10 +60,11 @@ ParticleTypeList ParticleTypeList::Make(const TCandidateList& cands)
 ParticleTypeList ParticleTypeList::Make(const TCandidateList& cands, const ParticleID& id)
 {
     ParticleTypeList list;
-    for(auto cand : cands.get_iter()) {
-        auto particle = id.Process(cand);
-        if(particle)
-            list.Add(particle);
+    ParticleID::types_t types;
+    id.IdentifyAll(cands, types);
+    for(size_t i=0;i<cands.size();i++) {
+        if(types[i] != nullptr)
+            list.Add(std::make_shared<TParticle>(*types[i], cands.get_ptr_at(i)));
     }
 
     return list;
@@ -261,18 +262,16 @@ const TParticleList ParticleTools::FindParticles(const ParticleTypeDatabase::Typ
 
 void ParticleTools::FillIMCombinations(TH1* h, unsigned n, const TParticleList& particles)
 {
-    FillIMCombinations([h] (double x) {h->Fill(x);}, n, particles);
+    IMCombinations im_combinations;
+    for(auto im : im_combinations.Calc(particles, n))
+        h->Fill(im);
 }
 
 void ParticleTools::FillIMCombinations(std::function<void(double)> filler, unsigned n, const TParticleList& particles)
 {
-    for( auto comb = makeCombination(particles,n); !comb.Done(); ++comb) {
-         LorentzVec sum({0,0,0},0);
-         for(const auto& p : comb) {
-             sum += *p;
-         }
-         filler(sum.M());
-    }
+    IMCombinations im_combinations;
+    for(auto im : im_combinations.Calc(particles, n))
+        filler(im);
 }
 
 bool ParticleTools::SortParticleByName(const TParticlePtr& a, const TParticlePtr& b)
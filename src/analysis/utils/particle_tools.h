@@ -124,6 +124,7 @@ struct ParticleTools {
      * @param h histogram to be filled with Fill(invariant mass)
      * @param n multiplicity or number of particles drawn from particles
      * @param particles list of particles
+     * @note use an IMCombinations member to re-use its buffers between events
      */
     static void FillIMCombinations(TH1* h, unsigned n, const TParticleList& particles);
 
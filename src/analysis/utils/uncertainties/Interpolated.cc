@@ -12,6 +12,8 @@
 #include "TAxis.h"
 #include "TH2D.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace ant;
 using namespace ant::analysis::utils;
@@ -30,6 +32,8 @@ Interpolated::~Interpolated()
 
 }
 
+unsigned Interpolated::LookupTableBins = 0;
+
 Uncertainties_t Interpolated::GetSigmas(const TParticle& particle) const
 {
     auto u_starting = starting_uncertainty ?
@@ -40,6 +44,28 @@ Uncertainties_t Interpolated::GetSigmas(const TParticle& particle) const
         return u_starting;
 
     auto u = u_starting;
+    SetUncertainties(u, u_starting, particle);
+    return u;
+}
+
+void Interpolated::GetAllSigmas(const TParticleList& particles, std::vector<Uncertainties_t>& sigmas) const
+{
+    if(starting_uncertainty)
+        starting_uncertainty->GetAllSigmas(particles, sigmas);
+    else
+        sigmas.assign(particles.size(), Uncertainties_t{});
+
+    if(!loaded_sigmas)
+        return;
+
+    for(size_t i=0;i<particles.size();i++) {
+        const auto u_starting = sigmas[i];
+        SetUncertainties(sigmas[i], u_starting, *particles[i]);
+    }
+}
+
+void Interpolated::SetUncertainties(Uncertainties_t& u, const Uncertainties_t& u_starting, const TParticle& particle) const
+{
     auto& detector = particle.Candidate->Detector;
     if(detector & Detector_t::Type_t::CB) {
         if(particle.Type() == ParticleTypeDatabase::Photon) {
@@ -73,8 +99,22 @@ Uncertainties_t Interpolated::GetSigmas(const TParticle& particle) const
             u.sigmaEk = 0;
         }
     }
+}
 
-    return u;
+double Interpolated::BakeLookupTables(unsigned nBins)
+{
+    if(!loaded_sigmas)
+        throw Exception("No sigmas loaded which could be baked");
+
+    const double maxdev = std::max({
+                                       cb_photon.Bake(nBins, "sigma_photon_cb"),
+                                       cb_proton.Bake(nBins, "sigma_proton_cb"),
+                                       taps_photon.Bake(nBins, "sigma_photon_taps"),
+                                       taps_proton.Bake(nBins, "sigma_proton_taps")
+                                   });
+    LOG(INFO) << "Baked uncertainty interpolations into " << nBins << "x" << nBins
+              << " lookup tables, max deviation " << maxdev;
+    return maxdev;
 }
 
 
@@ -158,6 +198,9 @@ std::shared_ptr<Interpolated> Interpolated::makeAndLoad(
     if(!default_model && !s->HasLoadedSigmas()) {
         throw Exception("No default model provided and sigmas could not be loaded");
     }
+    if(LookupTableBins>0 && s->HasLoadedSigmas()) {
+        s->BakeLookupTables(LookupTableBins);
+    }
     return s;
 }
 
@@ -203,6 +246,19 @@ void Interpolated::EkThetaPhiR::Load(const WrapTFile& file, const std::string& p
     ShowerDepth.setInterpolator(  LoadInterpolator(file, prefix+"/h_NewShowerDepth"));
 }
 
+double Interpolated::EkThetaPhiR::Bake(unsigned nBins, const string& prefix)
+{
+    const double dev_Ek          = Ek.Bake(nBins, nBins);
+    const double dev_Theta       = Theta.Bake(nBins, nBins);
+    const double dev_Phi         = Phi.Bake(nBins, nBins);
+    const double dev_CB_R        = CB_R.Bake(nBins, nBins);
+    const double dev_ShowerDepth = ShowerDepth.Bake(nBins, nBins);
+    VLOG(5) << prefix << " max deviations of lookup tables: "
+            << "Ek=" << dev_Ek << " Theta=" << dev_Theta << " Phi=" << dev_Phi
+            << " CB_R=" << dev_CB_R << " ShowerDepth=" << dev_ShowerDepth;
+    return std::max({dev_Ek, dev_Theta, dev_Phi, dev_CB_R, dev_ShowerDepth});
+}
+
 ostream& Interpolated::EkThetaPhiR::Print(ostream& stream) const
 {
     stream << "Ek:\t\t"        << Ek     << "\n";
@@ -233,6 +289,19 @@ void Interpolated::EkRxyPhiL::Load(const WrapTFile& file, const std::string& pre
     ShowerDepth.setInterpolator(   LoadInterpolator(file, prefix+"/h_NewShowerDepth"));
 }
 
+double Interpolated::EkRxyPhiL::Bake(unsigned nBins, const string& prefix)
+{
+    const double dev_Ek          = Ek.Bake(nBins, nBins);
+    const double dev_TAPS_Rxy    = TAPS_Rxy.Bake(nBins, nBins);
+    const double dev_Phi         = Phi.Bake(nBins, nBins);
+    const double dev_TAPS_L      = TAPS_L.Bake(nBins, nBins);
+    const double dev_ShowerDepth = ShowerDepth.Bake(nBins, nBins);
+    VLOG(5) << prefix << " max deviations of lookup tables: "
+            << "Ek=" << dev_Ek << " TAPS_Rxy=" << dev_TAPS_Rxy << " Phi=" << dev_Phi
+            << " TAPS_L=" << dev_TAPS_L << " ShowerDepth=" << dev_ShowerDepth;
+    return std::max({dev_Ek, dev_TAPS_Rxy, dev_Phi, dev_TAPS_L, dev_ShowerDepth});
+}
+
 ostream& Interpolated::EkRxyPhiL::Print(ostream& stream) const
 {
     stream << "Ek:\t\t"        << Ek     << "\n";
@@ -25,9 +25,22 @@ public:
     virtual ~Interpolated();
 
     Uncertainties_t GetSigmas(const TParticle &particle) const override;
+    void GetAllSigmas(const TParticleList& particles, std::vector<Uncertainties_t>& sigmas) const override;
 
     void LoadSigmas(const std::string& filename);
 
+    /**
+     * @brief BakeLookupTables replaces the interpolated surfaces by uniform grids
+     * with nBins*nBins points, the numerical error is reported to the log
+     * @return the maximum absolute deviation over all surfaces
+     */
+    double BakeLookupTables(unsigned nBins);
+
+    /**
+     * @brief LookupTableBins if non-zero, makeAndLoad bakes the loaded surfaces
+     */
+    static unsigned LookupTableBins;
+
     bool HasLoadedSigmas() const {
         return loaded_sigmas;
     }
@@ -43,6 +56,8 @@ protected:
 
     bool loaded_sigmas = false;
 
+    void SetUncertainties(Uncertainties_t& u, const Uncertainties_t& u_starting, const TParticle& particle) const;
+
     static std::unique_ptr<const Interpolator2D> LoadInterpolator(const WrapTFile& file, const std::string& prefix);
 
     struct EkThetaPhiR : ant::printable_traits {
@@ -55,6 +70,7 @@ protected:
 
         void SetUncertainties(Uncertainties_t& u, const TParticle& particle) const;
         void Load(const WrapTFile& file, const std::string& prefix);
+        double Bake(unsigned nBins, const std::string& prefix);
         std::ostream& Print(std::ostream& stream) const override;
     };
 
@@ -68,6 +84,7 @@ protected:
 
         void SetUncertainties(Uncertainties_t& u, const TParticle& particle) const;
         void Load(const WrapTFile& file, const std::string& prefix);
+        double Bake(unsigned nBins, const std::string& prefix);
         std::ostream& Print(std::ostream& stream) const override;
     };
 
@@ -29,6 +29,7 @@ ostream& ant::ClippedInterpolatorWrapper::Print(ostream& stream) const
 
 void ant::ClippedInterpolatorWrapper::setInterpolator(ClippedInterpolatorWrapper::interpolator_ptr_t i) {
     interp = move(i);
+    grid = nullptr;
     xrange = interp->getXRange();
     yrange = interp->getYRange();
 }
@@ -127,9 +128,17 @@ double ant::ClippedInterpolatorWrapper::GetPoint(double x, double y) const
 {
     x = xrange.clip(x);
     y = yrange.clip(y);
+    if(grid)
+        return grid->GetPoint(x,y);
     return interp->GetPoint(x,y);
 }
 
+double ant::ClippedInterpolatorWrapper::Bake(unsigned nx, unsigned ny)
+{
+    grid = std_ext::make_unique<UniformGrid2D>(*interp, nx, ny);
+    return grid->MaxDeviation(*interp);
+}
+
 ant::ClippedInterpolatorWrapper::~ClippedInterpolatorWrapper()
 {}
 
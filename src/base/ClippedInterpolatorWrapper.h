@@ -18,6 +18,10 @@ struct ClippedInterpolatorWrapper : ant::printable_traits {
 
     interpolator_ptr_t interp;
 
+    // optional baked lookup table, used instead of interp if present
+    using grid_ptr_t = std::unique_ptr<const ant::UniformGrid2D>;
+    grid_ptr_t grid;
+
     struct boundsCheck_t : ant::printable_traits {
         ant::interval<double> range;
         mutable unsigned underflow = 0;
@@ -41,6 +45,12 @@ struct ClippedInterpolatorWrapper : ant::printable_traits {
 
     void setInterpolator(interpolator_ptr_t i);
 
+    /**
+     * @brief Bake the interpolator into a uniform grid with nx*ny points for faster lookup
+     * @return the maximum absolute deviation from the interpolator
+     */
+    double Bake(unsigned nx, unsigned ny);
+
     std::ostream& Print(std::ostream& stream) const override;
 
     static std::unique_ptr<const Interpolator2D> makeInterpolator(TH2D* hist);
@@ -2,6 +2,7 @@
 
 #include "base/interval.h"
 #include "base/std_ext/string.h"
+#include "base/std_ext/memory.h"
 
 #include <sstream>
 #include <map>
@@ -9,6 +10,55 @@
 using namespace ant;
 using namespace std;
 
+Detector_t::Detector_t(const Type_t& type) :
+    Type(type),
+    geometry(std_ext::make_unique<Geometry_t>())
+{}
+
+Detector_t::~Detector_t() = default;
+
+void Detector_t::BuildGeometry() const
+{
+    geometry->Build(*this);
+    geometryValid = true;
+}
+
+void Detector_t::Geometry_t::Build(const Detector_t& detector)
+{
+    *this = Geometry_t();
+
+    // detectors without positions throw
+    unsigned nChannels = 0;
+    try {
+        nChannels = detector.GetNChannels();
+        if(nChannels>0)
+            detector.GetPosition(0);
+    }
+    catch(const Detector_t::Exception&) {
+        return;
+    }
+
+    NChannels = nChannels;
+    Positions.reserve(NChannels);
+    for(unsigned ch=0;ch<NChannels;ch++)
+        Positions.emplace_back(detector.GetPosition(ch));
+
+    auto clusterdetector = dynamic_cast<const ClusterDetector_t*>(addressof(detector));
+    if(!clusterdetector)
+        return;
+
+    ClusterElements.reserve(NChannels);
+    neighbourMatrix.assign(NChannels*NChannels, false);
+    for(unsigned ch=0;ch<NChannels;ch++) {
+        auto element = clusterdetector->GetClusterElement(ch);
+        ClusterElements.emplace_back(element);
+        for(auto neighbour : element->Neighbours) {
+            if(neighbour<NChannels)
+                neighbourMatrix[ch*NChannels+neighbour] = true;
+        }
+    }
+}
+
 const Detector_t::Any_t Detector_t::Any_t::None;
 const Detector_t::Any_t Detector_t::Any_t::Tracker(Type_t::MWPC0 | Type_t::MWPC1);
 const Detector_t::Any_t Detector_t::Any_t::CB_Apparatus(Detector_t::Any_t::Tracker | Type_t::PID | Type_t::CB );
@@ -11,6 +11,7 @@
 #include <type_traits>
 #include <vector>
 #include <string>
+#include <memory>
 
 namespace ant {
 
@@ -97,14 +98,34 @@ struct Detector_t : printable_traits {
         using std::runtime_error::runtime_error; // use base class constructor
     };
 
-    virtual ~Detector_t() = default;
+    struct Geometry_t;
+
+    /**
+     * @brief GetGeometry returns the element geometry as flat arrays indexed by channel
+     * @return reference stays valid, the content is rebuilt if the detector changed its elements
+     * @see Geometry_t
+     */
+    const Geometry_t& GetGeometry() const {
+        if(!geometryValid)
+            BuildGeometry();
+        return *geometry;
+    }
+
+    virtual ~Detector_t();
     virtual std::ostream& Print(std::ostream& stream) const override {
         return stream << "Detector_t " << ToString(Type);
     }
 protected:
-    Detector_t(const Type_t& type) :
-        Type(type) {}
+    Detector_t(const Type_t& type);
     Detector_t(const Detector_t&) = delete; // disable copy
+
+    // call when positions or neighbours of elements changed
+    void InvalidateGeometry() { geometryValid = false; }
+
+private:
+    void BuildGeometry() const;
+    const std::unique_ptr<Geometry_t> geometry;
+    mutable bool geometryValid = false;
 };
 
 /**
@@ -163,6 +184,36 @@ protected:
         Detector_t(type) {}
 };
 
+/**
+ * @brief The Detector_t::Geometry_t struct caches the geometry of the detector elements
+ *
+ * Built on the first Detector_t::GetGeometry() call, as the positions don't change during
+ * event processing. Avoids the virtual GetPosition() and GetClusterElement() calls and the
+ * neighbour list searches in the inner loops of the reconstruction.
+ * Detectors without positions, such as taggers, have an empty geometry.
+ */
+struct Detector_t::Geometry_t {
+    unsigned NChannels = 0;
+
+    std::vector<vec3> Positions;
+
+    // only for ClusterDetector_t, otherwise empty
+    std::vector<const ClusterDetector_t::Element_t*> ClusterElements;
+
+    /**
+     * @brief IsNeighbour checks if ch2 is listed as neighbour of ch1
+     * @note no boundary checks on channels performed
+     */
+    bool IsNeighbour(unsigned ch1, unsigned ch2) const {
+        return neighbourMatrix[ch1*NChannels+ch2];
+    }
+
+    void Build(const Detector_t& detector);
+
+private:
+    std::vector<bool> neighbourMatrix;
+};
+
 struct TaggerDetector_t : Detector_t {
 
     virtual double GetPhotonEnergy(unsigned channel) const = 0;
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Tree.h"
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace ant {
+
+/**
+ * @brief The FlatTree class is the compact on-disk encoding of a Tree
+ *
+ * The nodes are stored depth-first in pre-order, together with the index
+ * of their parent. This serializes much more compactly than the Tree itself.
+ * It is not meant for traversal, use the constructor to flatten a Tree before
+ * writing it, and MakeTree() to get it back after reading.
+ */
+template<typename T>
+class FlatTree {
+public:
+    using index_t = std::uint32_t;
+    static constexpr index_t npos = std::numeric_limits<index_t>::max();
+
+    FlatTree() = default;
+
+    explicit FlatTree(const typename Tree<T>::node_t& root) {
+        if(root)
+            Add(*root, npos);
+    }
+
+    /**
+     * @brief MakeTree creates the pointer-linked Tree again
+     * @return root node, or nullptr if empty
+     */
+    typename Tree<T>::node_t MakeTree() const {
+        std::vector<typename Tree<T>::node_t> nodes;
+        nodes.reserve(Size());
+        for(index_t i=0;i<Size();i++) {
+            nodes.emplace_back(Tree<T>::MakeNode(data[i]));
+            if(parents[i] != npos)
+                nodes[parents[i]]->AddDaughter(nodes.back());
+        }
+        // restore the sorted flags after all daughters were added
+        for(index_t i=0;i<Size();i++)
+            nodes[i]->is_sorted = sorted[i];
+        return nodes.empty() ? nullptr : nodes.front();
+    }
+
+    index_t Size() const { return static_cast<index_t>(data.size()); }
+    bool Empty() const { return data.empty(); }
+
+    template<class Archive>
+    void save(Archive& archive) const {
+        archive(data, parents, sorted);
+    }
+
+    template<class Archive>
+    void load(Archive& archive) {
+        archive(data, parents, sorted);
+        if(parents.size() != data.size() || sorted.size() != data.size())
+            throw std::runtime_error("FlatTree corrupt: array sizes differ");
+        Check();
+    }
+
+protected:
+    std::vector<T>        data;
+    std::vector<index_t>  parents;
+    std::vector<std::uint8_t> sorted;
+
+    void Add(const Tree<T>& node, index_t parent) {
+        const index_t i = Size();
+        data.emplace_back(node.Get());
+        parents.emplace_back(parent);
+        sorted.emplace_back(node.is_sorted);
+        for(const auto& daughter : node.Daughters())
+            Add(*daughter, i);
+    }
+
+    void Check() const {
+        for(index_t i=0;i<Size();i++) {
+            const auto p = parents[i];
+            if(p == npos) {
+                if(i != 0)
+                    throw std::runtime_error("FlatTree corrupt: more than one root");
+                continue;
+            }
+            // pre-order guarantees that parents come first
+            if(p >= i)
+                throw std::runtime_error("FlatTree corrupt: parent after daughter");
+        }
+    }
+};
+
+template<typename T>
+constexpr typename FlatTree<T>::index_t FlatTree<T>::npos;
+
+} // namespace ant
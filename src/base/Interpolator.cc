@@ -4,11 +4,13 @@ extern "C" {
 #include "detail/interp2d/interp2d_spline.h"
 }
 
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 using namespace ant;
 
 struct Interpolator2D::interp2d : ::interp2d {};
-struct Interpolator2D::gsl_interp_accel : ::gsl_interp_accel {};
 
 const interp2d_type* getType(Interpolator2D::Type type) {
     switch(type) {
@@ -28,19 +30,46 @@ Interpolator2D::Interpolator2D(const std::vector<double>& x,
     X(x), Y(y), Z(z),
     interp(static_cast<interp2d*>(
                interp2d_alloc(getType(type), X.size(), Y.size())
-               ), interp2d_free),
-    xa(static_cast<gsl_interp_accel*>(gsl_interp_accel_alloc()), gsl_interp_accel_free),
-    ya(static_cast<gsl_interp_accel*>(gsl_interp_accel_alloc()), gsl_interp_accel_free)
+               ), interp2d_free)
 {
     if(X.size()*Y.size() != Z.size())
         throw Exception("X*Y grid must match to Z values");
     interp2d_init(interp.get(), X.data(), Y.data(), Z.data(), X.size(), Y.size());
+    x_locator = locator_t(X);
+    y_locator = locator_t(Y);
+}
+
+Interpolator2D::locator_t::locator_t(const vector<double>& v)
+{
+    if(v.size() < 2)
+        throw Exception("Grid needs at least two points in each direction");
+    Start = v.front();
+    Scale = (v.size()-1)/(v.back()-v.front());
+    Last = v.size()-2;
 }
 
 double Interpolator2D::GetPoint(double x, double y) const
 {
-    return interp2d_eval(interp.get(), X.data(), Y.data(), Z.data(), x, y,
-                         xa.get(), ya.get());
+    // accelerators local to this call, seeded with the guessed cell.
+    // GSL's accel_find checks the guess and bisects if it was wrong,
+    // so the same cell is found as without any accelerator
+    ::gsl_interp_accel xa{x_locator.Guess(x), 0, 0};
+    ::gsl_interp_accel ya{y_locator.Guess(y), 0, 0};
+    return interp2d_eval(interp.get(), X.data(), Y.data(), Z.data(), x, y, &xa, &ya);
+}
+
+void Interpolator2D::GetPoints(const double* x, const double* y, double* z, size_t n) const
+{
+    for(size_t i=0;i<n;i++)
+        z[i] = GetPoint(x[i], y[i]);
+}
+
+void Interpolator2D::GetPoints(const vector<double>& x, const vector<double>& y, vector<double>& z) const
+{
+    if(x.size() != y.size())
+        throw Exception("Number of x and y values must match");
+    z.resize(x.size());
+    GetPoints(x.data(), y.data(), z.data(), x.size());
 }
 
 interval<double> Interpolator2D::getXRange() const
@@ -52,3 +81,60 @@ interval<double> Interpolator2D::getYRange() const
 {
     return { interp->ymin, interp->ymax };
 }
+
+UniformGrid2D::UniformGrid2D(const Interpolator2D& source, unsigned nx_, unsigned ny_) :
+    nx(nx_), ny(ny_)
+{
+    if(nx<2 || ny<2)
+        throw Exception("Uniform grid needs at least two points in each direction");
+
+    const auto xrange = source.getXRange();
+    const auto yrange = source.getYRange();
+
+    xmin = xrange.Start();
+    ymin = yrange.Start();
+    dx = xrange.Length()/(nx-1);
+    dy = yrange.Length()/(ny-1);
+    inv_dx = 1.0/dx;
+    inv_dy = 1.0/dy;
+
+    Z.resize(nx*ny);
+    for(unsigned iy=0;iy<ny;iy++) {
+        // ensure that the last point is exactly at the border
+        const double y = iy == ny-1 ? yrange.Stop() : ymin + iy*dy;
+        for(unsigned ix=0;ix<nx;ix++) {
+            const double x = ix == nx-1 ? xrange.Stop() : xmin + ix*dx;
+            Z[ix + nx*iy] = source.GetPoint(x, y);
+        }
+    }
+}
+
+double UniformGrid2D::MaxDeviation(const Interpolator2D& source, unsigned nSteps) const
+{
+    const auto xrange = getXRange();
+    const auto yrange = getYRange();
+    const unsigned nx_fine = (nx-1)*nSteps+1;
+    const unsigned ny_fine = (ny-1)*nSteps+1;
+    const double dx_fine = xrange.Length()/(nx_fine-1);
+    const double dy_fine = yrange.Length()/(ny_fine-1);
+
+    double maxdev = 0;
+    for(unsigned iy=0;iy<ny_fine;iy++) {
+        const double y = std::min(ymin + iy*dy_fine, yrange.Stop());
+        for(unsigned ix=0;ix<nx_fine;ix++) {
+            const double x = std::min(xmin + ix*dx_fine, xrange.Stop());
+            maxdev = std::max(maxdev, std::abs(GetPoint(x, y) - source.GetPoint(x, y)));
+        }
+    }
+    return maxdev;
+}
+
+interval<double> UniformGrid2D::getXRange() const
+{
+    return { xmin, xmin + (nx-1)*dx };
+}
+
+interval<double> UniformGrid2D::getYRange() const
+{
+    return { ymin, ymin + (ny-1)*dy };
+}
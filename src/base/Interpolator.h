@@ -7,6 +7,14 @@
 
 namespace ant {
 
+/**
+ * @brief The Interpolator2D class interpolates z values given on a rectangular x,y grid
+ *
+ * Evaluation is reentrant, one instance may be shared by several threads. The grid cell
+ * of a point is located per call. For uniformly spaced grids, the cell is found
+ * arithmetically, otherwise by bisection. The result is always the same as from the
+ * underlying GSL interp2d evaluation.
+ */
 class Interpolator2D {
 public:
     enum class Type {
@@ -20,6 +28,12 @@ public:
 
     double GetPoint(double x, double y) const;
 
+    /**
+     * @brief GetPoints evaluates n points (x[i], y[i]) into z[i]
+     */
+    void GetPoints(const double* x, const double* y, double* z, std::size_t n) const;
+    void GetPoints(const std::vector<double>& x, const std::vector<double>& y, std::vector<double>& z) const;
+
     struct Exception : std::runtime_error {
         using std::runtime_error::runtime_error; // use base class constructor
     };
@@ -40,9 +54,87 @@ private:
     struct interp2d;
     deleted_unique_ptr<interp2d> interp;
 
-    struct gsl_interp_accel;
-    deleted_unique_ptr<gsl_interp_accel> xa;
-    deleted_unique_ptr<gsl_interp_accel> ya;
+    // linear index guess for grid lookup, exact for uniform grids
+    struct locator_t {
+        double Start = 0;
+        double Scale = 0;
+        std::size_t Last = 0; // last valid cell index
+        locator_t() = default;
+        explicit locator_t(const std::vector<double>& v);
+        std::size_t Guess(double v) const noexcept {
+            const double f = (v - Start)*Scale;
+            if(!(f > 0)) // also catches NaN
+                return 0;
+            if(f >= Last)
+                return Last;
+            return static_cast<std::size_t>(f);
+        }
+    };
+    locator_t x_locator;
+    locator_t y_locator;
+};
+
+/**
+ * @brief The UniformGrid2D class samples an Interpolator2D on a dense uniform grid
+ * and evaluates it by bilinear lookup. This is much cheaper than the GSL evaluation,
+ * but only an approximation of it, see MaxDeviation.
+ * Points outside the range are clamped to the border.
+ */
+class UniformGrid2D {
+public:
+
+    UniformGrid2D(const Interpolator2D& source, unsigned nx, unsigned ny);
+
+    double GetPoint(double x, double y) const noexcept {
+        unsigned ix, iy;
+        double tx, ty;
+        locate(x, xmin, inv_dx, nx, ix, tx);
+        locate(y, ymin, inv_dy, ny, iy, ty);
+        const double* z0 = std::addressof(Z[ix + nx*iy]);
+        const double* z1 = z0 + nx;
+        return (1.0-ty)*((1.0-tx)*z0[0] + tx*z0[1])
+                   + ty*((1.0-tx)*z1[0] + tx*z1[1]);
+    }
+
+    /**
+     * @brief MaxDeviation compares to the source on a grid which is nSteps times finer
+     * @return the maximum absolute difference
+     */
+    double MaxDeviation(const Interpolator2D& source, unsigned nSteps = 4) const;
+
+    interval<double> getXRange() const;
+    interval<double> getYRange() const;
+
+    using Exception = Interpolator2D::Exception;
+
+private:
+    unsigned nx;
+    unsigned ny;
+    double xmin;
+    double ymin;
+    double dx;
+    double dy;
+    double inv_dx;
+    double inv_dy;
+    std::vector<double> Z; // x is the fast index
+
+    static void locate(double v, double vmin, double inv_dv, unsigned n,
+                       unsigned& i, double& t) noexcept
+    {
+        const double f = (v - vmin)*inv_dv;
+        if(!(f > 0)) { // also catches NaN
+            i = 0;
+            t = 0;
+            return;
+        }
+        if(f >= n-1) {
+            i = n-2;
+            t = 1;
+            return;
+        }
+        i = static_cast<unsigned>(f);
+        t = f - i;
+    }
 };
 
 }
@@ -0,0 +1,100 @@
+#include "OutputProfile.h"
+
+#include "Logger.h"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+#include "TObjArray.h"
+#include "Compression.h"
+
+using namespace std;
+using namespace ant;
+
+const OutputProfile* OutputProfile::selected = nullptr;
+map<string, const OutputProfile*> OutputProfile::selectedForTree;
+
+namespace {
+
+const vector<OutputProfile>& profiles() {
+    // LZ4 is not available in ROOT 5, so fast uses the cheapest zlib level
+    static const vector<OutputProfile> p{
+        {"fast",     ROOT::kZLIB, 1, 128000,  -30000000},
+        {"balanced", ROOT::kZLIB, 4,  64000,  -30000000},
+        {"archive",  ROOT::kLZMA, 8, 256000, -100000000},
+    };
+    return p;
+}
+
+}
+
+int OutputProfile::GetCompressionSettings() const
+{
+    return ROOT::CompressionSettings(ROOT::ECompressionAlgorithm(Algorithm), Level);
+}
+
+const OutputProfile& OutputProfile::Get(const string& name)
+{
+    for(auto& p : profiles()) {
+        if(p.Name == name)
+            return p;
+    }
+    throw Exception("Unknown output profile '"+name+"'");
+}
+
+vector<string> OutputProfile::GetNames()
+{
+    vector<string> names;
+    for(auto& p : profiles())
+        names.emplace_back(p.Name);
+    return names;
+}
+
+void OutputProfile::Select(const string& name)
+{
+    selected = name.empty() ? nullptr : addressof(Get(name));
+}
+
+void OutputProfile::SelectForTree(const string& treename, const string& name)
+{
+    selectedForTree[treename] = addressof(Get(name));
+}
+
+void OutputProfile::Reset()
+{
+    selected = nullptr;
+    selectedForTree.clear();
+}
+
+const OutputProfile* OutputProfile::GetSelected(const string& treename)
+{
+    auto it = selectedForTree.find(treename);
+    if(it != selectedForTree.end())
+        return it->second;
+    return selected;
+}
+
+void OutputProfile::Apply(TFile& file)
+{
+    auto p = GetSelected();
+    if(!p)
+        return;
+    file.SetCompressionSettings(p->GetCompressionSettings());
+}
+
+void OutputProfile::Apply(TTree& tree)
+{
+    auto p = GetSelected(tree.GetName());
+    if(!p)
+        return;
+    tree.SetAutoFlush(p->AutoFlush);
+    tree.SetBasketSize("*", p->BasketSize);
+    // sets the sub-branches as well
+    auto branches = tree.GetListOfBranches();
+    for(int i=0;i<branches->GetEntriesFast();i++) {
+        auto branch = dynamic_cast<TBranch*>(branches->UncheckedAt(i));
+        if(branch)
+            branch->SetCompressionSettings(p->GetCompressionSettings());
+    }
+    VLOG(7) << "Applied output profile " << p->Name << " to tree " << tree.GetName();
+}
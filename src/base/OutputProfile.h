@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stdexcept>
+
+class TFile;
+class TTree;
+
+namespace ant {
+
+/**
+ * @brief The OutputProfile struct defines compression and basket layout of written trees
+ *
+ * A selected profile is applied to the files opened by WrapTFileOutput, and to the trees
+ * created by HistogramFactory::makeTTree (on their first Fill), WrapTTree::CreateBranches
+ * and the treeEvents of the PhysicsManager. Single trees can be given another profile by their name.
+ * If no profile is selected, ROOT's defaults are kept.
+ *
+ * Available profiles:
+ *   fast     : zlib level 1, for intermediate outputs which are read again soon
+ *   balanced : zlib level 4
+ *   archive  : LZMA level 8, for outputs which are kept
+ */
+struct OutputProfile {
+    std::string Name;
+    int Algorithm;       // as ROOT::ECompressionAlgorithm
+    int Level;
+    int BasketSize;      // in bytes, for each branch
+    long long AutoFlush; // as TTree::SetAutoFlush, negative values are bytes
+
+    int GetCompressionSettings() const;
+
+    /**
+     * @brief Get the profile by name
+     * @throw Exception if there's no such profile
+     */
+    static const OutputProfile& Get(const std::string& name);
+
+    static std::vector<std::string> GetNames();
+
+    /**
+     * @brief Select the profile for all trees, empty name selects ROOT's defaults again
+     */
+    static void Select(const std::string& name);
+
+    /**
+     * @brief SelectForTree overrides the selected profile for trees with the given name
+     */
+    static void SelectForTree(const std::string& treename, const std::string& name);
+
+    /**
+     * @brief Reset removes all selections
+     */
+    static void Reset();
+
+    /**
+     * @brief GetSelected finds the profile for the given tree
+     * @param treename if empty, the profile for files is returned
+     * @return nullptr if ROOT's defaults should be used
+     */
+    static const OutputProfile* GetSelected(const std::string& treename = "");
+
+    /**
+     * @brief Apply sets the compression of the file, used by all branches created in it later
+     */
+    static void Apply(TFile& file);
+
+    /**
+     * @brief Apply sets auto flush, basket size and compression of the tree
+     * @note call again after creating branches, as only existing branches are changed
+     */
+    static void Apply(TTree& tree);
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+protected:
+    static const OutputProfile* selected;
+    static std::map<std::string, const OutputProfile*> selectedForTree;
+};
+
+}
@@ -0,0 +1,214 @@
+#include "StageTimer.h"
+
+#include "Logger.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <ctime>
+
+using namespace std;
+using namespace ant;
+
+bool StageTimer::Enabled = false;
+string StageTimer::TraceFile;
+size_t StageTimer::MaxTraceEvents = 10000000;
+
+namespace {
+
+using clock_t_ = chrono::steady_clock;
+
+struct stage_t {
+    explicit stage_t(const string& name) : Name(name) {}
+    string Name;
+    bool Called = false;
+    unsigned Order = 0;
+    unsigned Level = 0; // nesting level when first called
+    uint64_t Calls = 0;
+    double WallSecs = 0;
+    double CpuSecs = 0;
+};
+
+struct trace_event_t {
+    StageTimer::id_t ID;
+    double Start_us;
+    double Duration_us;
+};
+
+struct registry_t {
+    vector<stage_t> stages;
+    vector<trace_event_t> trace;
+    clock_t_::time_point started = clock_t_::now();
+    unsigned level = 0;
+    unsigned nCalled = 0;
+};
+
+registry_t& registry() {
+    static registry_t r;
+    return r;
+}
+
+int64_t cpu_now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return int64_t(ts.tv_sec)*1000000000 + ts.tv_nsec;
+}
+
+string json_quote(const string& str) {
+    string q = "\"";
+    for(auto c : str) {
+        if(c == '"' || c == '\\')
+            q += '\\';
+        q += c;
+    }
+    return q + "\"";
+}
+
+}
+
+StageTimer::id_t StageTimer::Register(const string& name)
+{
+    auto& stages = registry().stages;
+    auto it = find_if(stages.begin(), stages.end(), [&name] (const stage_t& s) {
+        return s.Name == name;
+    });
+    if(it != stages.end())
+        return distance(stages.begin(), it);
+    stages.emplace_back(name);
+    return stages.size()-1;
+}
+
+void StageTimer::Scope::Start(id_t stage)
+{
+    id = stage;
+    running = true;
+    auto& r = registry();
+    auto& s = r.stages[id];
+    if(!s.Called) {
+        // the summary lists the stages in order of their first call
+        s.Called = true;
+        s.Order = r.nCalled++;
+        s.Level = r.level;
+    }
+    r.level++;
+    cpu_start_ns = cpu_now_ns();
+    wall_start = clock_t_::now();
+}
+
+void StageTimer::Scope::Stop()
+{
+    const auto wall_stop = clock_t_::now();
+    const auto cpu_stop_ns = cpu_now_ns();
+    running = false;
+
+    auto& r = registry();
+    r.level--;
+    auto& stage = r.stages[id];
+    const chrono::duration<double> wall = wall_stop - wall_start;
+    stage.Calls++;
+    stage.WallSecs += wall.count();
+    stage.CpuSecs += 1e-9*(cpu_stop_ns - cpu_start_ns);
+
+    if(!TraceFile.empty() && r.trace.size() < MaxTraceEvents) {
+        const chrono::duration<double, micro> start = wall_start - r.started;
+        r.trace.push_back({id, start.count(), 1e6*wall.count()});
+    }
+}
+
+uint64_t StageTimer::GetCalls(id_t stage)
+{
+    return registry().stages.at(stage).Calls;
+}
+
+double StageTimer::GetWallSeconds(id_t stage)
+{
+    return registry().stages.at(stage).WallSecs;
+}
+
+void StageTimer::Reset()
+{
+    auto& r = registry();
+    for(auto& stage : r.stages) {
+        stage = stage_t(stage.Name);
+    }
+    r.trace.clear();
+    r.nCalled = 0;
+    r.started = clock_t_::now();
+}
+
+void StageTimer::PrintSummary(ostream& s)
+{
+    const auto& r = registry();
+    const chrono::duration<double> total = clock_t_::now() - r.started;
+
+    s << left
+      << setw(40) << "Stage"
+      << right
+      << setw(12) << "Calls"
+      << setw(12) << "Wall/s"
+      << setw(12) << "CPU/s"
+      << setw(12) << "us/Call"
+      << setw(9)  << "% Wall" << '\n';
+    vector<const stage_t*> called;
+    for(const auto& stage : r.stages) {
+        if(stage.Calls > 0)
+            called.push_back(&stage);
+    }
+    sort(called.begin(), called.end(), [] (const stage_t* a, const stage_t* b) {
+        return a->Order < b->Order;
+    });
+
+    for(const auto stage_ptr : called) {
+        const auto& stage = *stage_ptr;
+        s << left
+          << setw(40) << string(2*stage.Level, ' ') + stage.Name
+          << right << fixed
+          << setw(12) << stage.Calls
+          << setw(12) << setprecision(3) << stage.WallSecs
+          << setw(12) << setprecision(3) << stage.CpuSecs
+          << setw(12) << setprecision(2) << 1e6*stage.WallSecs/stage.Calls
+          << setw(9)  << setprecision(1) << 100.0*stage.WallSecs/total.count() << '\n';
+    }
+    s.unsetf(ios_base::floatfield);
+}
+
+void StageTimer::WriteTrace(ostream& s)
+{
+    const auto& r = registry();
+    s << "{\"traceEvents\":[\n";
+    bool first = true;
+    for(const auto& e : r.trace) {
+        if(!first)
+            s << ",\n";
+        first = false;
+        s << fixed << setprecision(3)
+          << "{\"name\":" << json_quote(r.stages[e.ID].Name)
+          << ",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+          << ",\"ts\":" << e.Start_us
+          << ",\"dur\":" << e.Duration_us << "}";
+    }
+    s << "\n]}\n";
+    s.unsetf(ios_base::floatfield);
+}
+
+void StageTimer::Finish()
+{
+    if(!Enabled)
+        return;
+
+    stringstream ss;
+    PrintSummary(ss);
+    LOG(INFO) << "Time spent per stage (inclusive nested stages):\n" << ss.str();
+
+    if(TraceFile.empty())
+        return;
+    ofstream out(TraceFile);
+    WriteTrace(out);
+    if(out)
+        LOG(INFO) << "Wrote trace of " << registry().trace.size() << " intervals to " << TraceFile;
+    else
+        LOG(ERROR) << "Could not write trace to " << TraceFile;
+    if(registry().trace.size() >= MaxTraceEvents)
+        LOG(WARNING) << "Trace was truncated at " << MaxTraceEvents << " intervals";
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace ant {
+
+/**
+ * @brief The StageTimer struct accumulates wall and CPU time of named processing stages
+ *
+ * Stages are registered once by name, then each execution is measured by a Scope
+ * around it. Scopes may be nested, the times are then inclusive. If not Enabled,
+ * a Scope costs one branch only.
+ *
+ * Optionally, each measured interval is recorded for a trace in the Chrome
+ * trace event format, which can be viewed with chrome://tracing or Perfetto.
+ */
+struct StageTimer {
+
+    using id_t = unsigned;
+
+    /**
+     * @brief Enabled switches the measurement on/off at runtime
+     */
+    static bool Enabled;
+
+    /**
+     * @brief TraceFile if non-empty, intervals are recorded and written to it by Finish()
+     */
+    static std::string TraceFile;
+
+    /**
+     * @brief MaxTraceEvents limits the memory used for the trace, later intervals are dropped
+     */
+    static std::size_t MaxTraceEvents;
+
+    /**
+     * @brief Register a stage, registering the same name twice returns the same id
+     * @param name shown in summary and trace
+     * @return id to be used with Scope
+     */
+    static id_t Register(const std::string& name);
+
+    class Scope {
+    public:
+        explicit Scope(id_t stage) {
+            if(Enabled)
+                Start(stage);
+        }
+        ~Scope() {
+            if(running)
+                Stop();
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        id_t id = 0;
+        bool running = false;
+        std::chrono::steady_clock::time_point wall_start;
+        std::int64_t cpu_start_ns = 0;
+        void Start(id_t stage);
+        void Stop();
+    };
+
+    /**
+     * @brief GetCalls returns how often the stage was measured so far
+     */
+    static std::uint64_t GetCalls(id_t stage);
+
+    /**
+     * @brief GetWallSeconds returns the accumulated wall time of the stage
+     */
+    static double GetWallSeconds(id_t stage);
+
+    /**
+     * @brief Reset clears the accumulated times and the trace, but keeps the registered stages
+     */
+    static void Reset();
+
+    /**
+     * @brief PrintSummary writes a table with calls and times per stage, in order of their first call
+     */
+    static void PrintSummary(std::ostream& s);
+
+    /**
+     * @brief WriteTrace writes the recorded intervals as Chrome trace JSON
+     */
+    static void WriteTrace(std::ostream& s);
+
+    /**
+     * @brief Finish logs the summary and writes the TraceFile, if enabled
+     */
+    static void Finish();
+};
+
+}
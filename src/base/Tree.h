@@ -12,15 +12,22 @@
 #include <algorithm>
 #include <cassert>
 #include <numeric>
+#include <functional>
 
 namespace ant {
 
+template<typename T>
+class FlatTree;
+
 template<typename T>
 class Tree {
     // make Tree of different types friends
     // needed for IsEqual()
     template<typename>
     friend class Tree;
+    // needs the sorted flag
+    template<typename>
+    friend class FlatTree;
 
     template<typename U>
     using snode_t    = std::shared_ptr<Tree<U>>;
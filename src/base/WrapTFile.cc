@@ -5,6 +5,7 @@
 #include "std_ext/system.h"
 #include "std_ext/string.h"
 #include "Logger.h"
+#include "OutputProfile.h"
 
 #include "TSystem.h"
 #include "TH1D.h"
@@ -140,19 +141,29 @@ WrapTFileOutput::WrapTFileOutput(const std::string& filename, mode_t access_mode
     else
         file = openFile(filename, root_mode);
 
-    //file->SetCompressionAlgorithm(ROOT::kLZMA);
-    //file->SetCompressionLevel(5);
+    OutputProfile::Apply(*file);
 
     files.emplace_back(move(file));
+    opened = chrono::steady_clock::now();
 
     VLOG(5) << "Opened file " << filename << " in " << root_mode << "-mode.";
 }
 
 WrapTFileOutput::~WrapTFileOutput()
 {
+    const auto write_started = chrono::steady_clock::now();
     files.front()->Write();
+    const auto write_stopped = chrono::steady_clock::now();
+
+    // baskets are written while the job fills the trees, so the rate over the whole
+    // time the file was open is only the average output rate of the job, not the write throughput
+    const double mb = (double)files.front()->GetBytesWritten()/(1 << 20);
+    const double seconds = chrono::duration<double>(write_stopped - opened).count();
+    const double write_seconds = chrono::duration<double>(write_stopped - write_started).count();
     LOG(INFO) << "Wrote output file " <<  files.front()->GetName()
-              << " (" << (double)files.front()->GetBytesWritten()/(1 << 20) << " MB)";
+              << " (" << mb << " MB, average output rate of job " << (seconds>0 ? mb/seconds : 0)
+              << " MB/s over " << seconds << " s, final write " << write_seconds << " s, compression "
+              << files.front()->GetCompressionSettings() << ")";
 }
 
 void WrapTFileOutput::cd()
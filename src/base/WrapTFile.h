@@ -15,8 +15,10 @@
 #include <string>
 #include <list>
 #include <set>
+#include <vector>
 #include <stdexcept>
 #include <functional>
+#include <chrono>
 
 class TH1;
 class TH1D;
@@ -35,6 +37,21 @@ protected:
     WrapTFile(); // cannot be directly constructed, use WrapTFileInput or WrapTFileOutput
 
     static bool hasROOTmagic(const std::string& filename);
+
+    template <typename T>
+    static T* GetObjectFrom(TFile& file, const std::string& name) {
+        T* ptr = nullptr;
+        file.GetObject(name.c_str(), ptr);
+        if(ptr == nullptr) {
+            // GetObject did not work, try GetKey fallback
+            // useful for objects which have / in their names
+            TKey* key = file.GetKey(name.c_str());
+            if(key != nullptr) {
+                ptr = dynamic_cast<T*>(key->ReadObj());
+            }
+        }
+        return ptr;
+    }
 public:
 
     /**
@@ -92,16 +109,7 @@ public:
         std::string filename;
 
         for(auto& file : files) {
-            T* ptr_ = nullptr;
-            file->GetObject(name.c_str(), ptr_);
-            if(ptr_ == nullptr) {
-                // GetObject did not work, try GetKey fallback
-                // useful for objects which have / in their names
-                TKey* key = file->GetKey(name.c_str());
-                if(key != nullptr) {
-                    ptr_ = dynamic_cast<T*>(key->ReadObj());
-                }
-            }
+            T* ptr_ = GetObjectFrom<T>(*file, name);
 
             if(ptr == nullptr && ptr_ != nullptr) {
                 ptr = ptr_;
@@ -117,6 +125,21 @@ public:
         return ptr != nullptr;
     }
 
+    /**
+     * @brief GetObjects finds TObjects of type T and given name in all files
+     * @param name Name of the objects to get
+     * @return found objects in the order of the files, empty if not found at all
+     */
+    template <typename T>
+    std::vector<T*> GetObjects(const std::string& name) const {
+        std::vector<T*> objects;
+        for(auto& file : files) {
+            if(T* ptr = GetObjectFrom<T>(*file, name))
+                objects.push_back(ptr);
+        }
+        return objects;
+    }
+
     template<typename Hist>
     std::shared_ptr<Hist>  GetSharedHist(const std::string& name) const {
         Hist* hist = nullptr;
@@ -201,6 +224,10 @@ public:
 
     WrapTFileOutput(const WrapTFileOutput&) = delete;
     WrapTFileOutput& operator= (const WrapTFileOutput&) = delete;
+
+protected:
+    // for the write throughput
+    std::chrono::steady_clock::time_point opened;
 };
 
 class WrapTFileInput: public WrapTFile {
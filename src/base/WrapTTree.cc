@@ -1,4 +1,5 @@
 #include "WrapTTree.h"
+#include "OutputProfile.h"
 
 #include "base/std_ext/vector.h"
 #include "base/Logger.h"
@@ -20,6 +21,7 @@ void WrapTTree::CreateBranches(TTree* tree) {
         // dereference ValuePtr here to pointer to value
         tree_trick->BranchImpRef(b.Name.c_str(), b.ROOTClass, b.ROOTType, *b.ValuePtr, 32000, 99);
     }
+    OutputProfile::Apply(*Tree);
 }
 
 void WrapTTree::LinkBranches(TTree* tree) {
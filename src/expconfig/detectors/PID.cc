@@ -77,4 +77,5 @@ void PID::RotateElements()
         // the element is already initialized as a unit vector
         element.Position.SetPhi(std_ext::degree_to_radian(phi_offset0_degrees) + i*dPhi(element.Channel));
     }
+    InvalidateGeometry();
 }
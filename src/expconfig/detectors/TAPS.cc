@@ -31,10 +31,6 @@ void TAPS::SetElementFlags(unsigned channel, const ElementFlags_t& flags) {
     }
 }
 
-double TAPS::GetTimeOfFlight(double clustertime, unsigned channel, double trigger_reftime) const {
-    return clustertime - clusterelements.at(channel)->ToFOffset - trigger_reftime;
-}
-
 double TAPS::GetBeta(const TCandidate& cand_taps, double trigger_reftime) const {
     const auto taps_cluster = cand_taps.FindCaloCluster();
     if(!taps_cluster)
@@ -42,8 +42,11 @@ struct TAPS :
      * @param channel central element
      * @param trigger_reftime usually given by trigger, e.g. energy-averaged CB timing
      * @return time in nanoseconds
+     * @note not virtual, as it's called for every TAPS cluster
      */
-    virtual double GetTimeOfFlight(double clustertime, unsigned channel, double trigger_reftime) const;
+    double GetTimeOfFlight(double clustertime, unsigned channel, double trigger_reftime) const {
+        return clustertime - clusterelements.at(channel)->ToFOffset - trigger_reftime;
+    }
 
     /**
      * @brief GetBeta uses GetTimeOfFlight() to calculate the beta=v/c of the particle
@@ -112,6 +112,12 @@ public:
 
     virtual unsigned long Sample(const unsigned long &nevts) const override;
 
+    /**
+     * @brief SetSeed reseeds the engine picking energies and reactions,
+     * which is seeded randomly by default
+     */
+    void SetSeed(unsigned seed) { _rndEngine->SetSeed(seed); }
+
     virtual ~Cocktail(){}
 
 };
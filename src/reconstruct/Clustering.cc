@@ -24,6 +24,7 @@ void Clustering_NextGen::Build(const ClusterDetector_t& clusterdetector,
 {
     // clustering detector, so we need additional information
     // to build the crystals_t
+    const auto& geometry = clusterdetector.GetGeometry();
     list<clustering::crystal_t> crystals;
     for(const TClusterHit& hit : clusterhits) {
         // try to include as many hits as possible
@@ -32,14 +33,14 @@ void Clustering_NextGen::Build(const ClusterDetector_t& clusterdetector,
         }
         crystals.emplace_back(
                     hit.Energy,
-                    clusterdetector.GetClusterElement(hit.Channel),
+                    geometry.ClusterElements[hit.Channel],
                     addressof(hit)
                     );
     }
 
     // do the clustering (calls detail/Clustering_NextGen.h code)
     vector< clustering::cluster_t > crystal_clusters;
-    clustering::do_clustering(crystals, crystal_clusters);
+    clustering::do_clustering(crystals, geometry, crystal_clusters);
 
     // now calculate some cluster properties,
     // and create TCluster out of it
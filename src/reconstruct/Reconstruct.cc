@@ -16,11 +16,40 @@
 #include <iterator>
 #include <limits>
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <typeinfo>
+#include <cxxabi.h>
 
 using namespace std;
 using namespace ant;
 using namespace ant::reconstruct;
 
+double Reconstruct::PrefilterCBEnergySum = std::numeric_limits<double>::quiet_NaN();
+
+namespace {
+template<typename Hook>
+void RegisterTimers(const list<shared_ptr<Hook>>& hooks, const string& kind,
+                    vector<StageTimer::id_t>& timers)
+{
+    timers.clear();
+    for(const auto& hook : hooks) {
+        // name the stage after the dynamic type of the hook, usually a calibration
+        const auto& hook_ref = *hook;
+        char* demangled = abi::__cxa_demangle(typeid(hook_ref).name(), nullptr, nullptr, nullptr);
+        string name = demangled ? demangled : typeid(hook_ref).name();
+        free(demangled);
+        for(const string prefix : {"ant::calibration::", "ant::"}) {
+            if(name.compare(0, prefix.size(), prefix) == 0) {
+                name = name.substr(prefix.size());
+                break;
+            }
+        }
+        timers.emplace_back(StageTimer::Register(name + " (" + kind + ")"));
+    }
+}
+}
+
 Reconstruct::Reconstruct() {}
 
 // implement the destructor here,
@@ -43,6 +72,10 @@ void Reconstruct::Initialize(const TID& tid)
         std_ext::AddToSharedPtrList<ReconstructHook::EventData, ReconstructHook::Base>
                 (hook, hooks_eventdata);
     }
+    RegisterTimers(hooks_readhits,    "ReadHits",    timers_readhits);
+    RegisterTimers(hooks_clusterhits, "ClusterHits", timers_clusterhits);
+    RegisterTimers(hooks_clusters,    "Clusters",    timers_clusters);
+    RegisterTimers(hooks_eventdata,   "EventData",   timers_eventdata);
 
     // put the detectors in a map for convenient access
     const shared_ptr_list<Detector_t>& detectors = setup->GetDetectors();
@@ -72,6 +105,8 @@ void Reconstruct::Initialize(const TID& tid)
 
 void Reconstruct::DoReconstruct(TEventData& reconstructed)
 {
+    prefiltered = false;
+
     // ignore empty events
     if(reconstructed.DetectorReadHits.empty())
         return;
@@ -81,7 +116,10 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed)
     }
 
     // update the updateables :)
-    updateablemanager->UpdateParameters(reconstructed.ID);
+    {
+        StageTimer::Scope timer(stage_timers.Updateables);
+        updateablemanager->UpdateParameters(reconstructed.ID);
+    }
 
     // apply the hooks for detector read hits (mostly calibrations),
     // note that this also changes the hits itself
@@ -90,33 +128,54 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed)
     // the detectorReads are now calibrated as far as possible
     // one might return now and detectorRead is just calibrated...
 
+    // ...which we do if the event does not pass the prefilter
+    if(ApplyPrefilter(reconstructed)) {
+        prefiltered = true;
+        return;
+    }
+
 
     // do the hit matching, which builds the TClusterHit's
     // put into the AdaptorTClusterHit to track Energy/Timing information
     // for subsequent clustering
     sorted_bydetectortype_t<TClusterHit> sorted_clusterhits;
-    BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    {
+        StageTimer::Scope timer(stage_timers.BuildHits);
+        BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    }
 
     // apply hooks which modify clusterhits
+    auto it_timer = timers_clusterhits.begin();
     for(const auto& hook : hooks_clusterhits) {
+        StageTimer::Scope timer(*it_timer++);
         hook->ApplyTo(sorted_clusterhits);
     }
 
     // then build clusters (at least for calorimeters this is not trivial)
     sorted_clusters_t sorted_clusters;
-    BuildClusters(move(sorted_clusterhits), sorted_clusters);
+    {
+        StageTimer::Scope timer(stage_timers.Clustering);
+        BuildClusters(move(sorted_clusterhits), sorted_clusters);
+    }
 
     // apply hooks which modify clusters
+    it_timer = timers_clusters.begin();
     for(const auto& hook : hooks_clusters) {
+        StageTimer::Scope timer(*it_timer++);
         hook->ApplyTo(sorted_clusters);
     }
 
     // do the candidate building
-    candidatebuilder->Build(move(sorted_clusters),
-                            reconstructed.Candidates, reconstructed.Clusters);
+    {
+        StageTimer::Scope timer(stage_timers.Candidates);
+        candidatebuilder->Build(move(sorted_clusters),
+                                reconstructed.Candidates, reconstructed.Clusters);
+    }
 
     // apply hooks which may modify the whole event
+    it_timer = timers_eventdata.begin();
     for(const auto& hook : hooks_eventdata) {
+        StageTimer::Scope timer(*it_timer++);
         hook->ApplyTo(reconstructed);
     }
 
@@ -136,11 +195,36 @@ void Reconstruct::ApplyHooksToReadHits(
 
     // apply calibration
     // this may change the given readhits
+    StageTimer::Scope timer(stage_timers.ReadHits);
+    auto it_timer = timers_readhits.begin();
     for(const auto& hook : hooks_readhits) {
+        StageTimer::Scope hook_timer(*it_timer++);
         hook->ApplyTo(sorted_readhits);
     }
 }
 
+bool Reconstruct::ApplyPrefilter(TEventData& reconstructed) const
+{
+    if(!std::isfinite(PrefilterCBEnergySum))
+        return false;
+
+    // same sum as calculated by the Trigger detector,
+    // but it is available before any clustering happened
+    double CBEnergySum = 0.0;
+    for(const TDetectorReadHit& readhit : sorted_readhits.get_item(Detector_t::Type_t::CB)) {
+        if(readhit.ChannelType != Channel_t::Type_t::Integral)
+            continue;
+        for(auto& energy : readhit.Values)
+            CBEnergySum += energy.Calibrated;
+    }
+
+    if(CBEnergySum >= PrefilterCBEnergySum)
+        return false;
+
+    reconstructed.Trigger.CBEnergySum = CBEnergySum;
+    return true;
+}
+
 void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_clusterhits,
         vector<TTaggerHit>& taggerhits)
 {
@@ -290,6 +374,7 @@ void Reconstruct::BuildClusters(
         else {
             // in case of no clustering detector,
             // build simple "cluster" consisting of single TClusterHit
+            const auto& geometry = detector.Detector->GetGeometry();
             for(const TClusterHit& hit : clusterhits) {
 
                 // ignore hits with time and energy information
@@ -298,7 +383,7 @@ void Reconstruct::BuildClusters(
 
 
                 clusters.emplace_back(
-                                          detector.Detector->GetPosition(hit.Channel),
+                                          geometry.Positions[hit.Channel],
                                           hit.Energy,
                                           hit.Time,
                                           detector.Detector->Type,
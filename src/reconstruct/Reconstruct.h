@@ -5,6 +5,8 @@
 
 #include "Reconstruct_traits.h"
 
+#include "base/StageTimer.h"
+
 namespace ant {
 
 struct TTaggerHit;
@@ -23,8 +25,19 @@ public:
     // into a calibrated TEvent
     virtual void DoReconstruct(TEventData& reconstructed) override;
 
+    virtual bool Prefiltered() const override { return prefiltered; }
+
     ~Reconstruct();
 
+    /**
+     * @brief PrefilterCBEnergySum skips clustering and candidate building for events
+     * with calibrated CB energy sum below this threshold, NaN disables the prefilter
+     *
+     * The event still flows through the analysis chain (for example for slowcontrol
+     * processing), but is not handed to the physics classes.
+     */
+    static double PrefilterCBEnergySum;
+
     class Exception : public std::runtime_error {
         using std::runtime_error::runtime_error; // use base class constructor
     };
@@ -35,6 +48,7 @@ protected:
 
     bool initialized = false;
     bool includeIgnoredElements = false;
+    bool prefiltered = false;
 
     virtual void Initialize(const TID& tid);
 
@@ -43,6 +57,8 @@ protected:
 
     void ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorReadHits);
 
+    bool ApplyPrefilter(TEventData& reconstructed) const;
+
     template<typename T>
     using sorted_bydetectortype_t = std::map<Detector_t::Type_t, std::vector< T > >;
 
@@ -93,6 +109,21 @@ protected:
     shared_ptr_list<ReconstructHook::Clusters>         hooks_clusters;
     shared_ptr_list<ReconstructHook::EventData>        hooks_eventdata;
 
+    // stage timers of the hooks above, in the same order
+    using timers_t = std::vector<StageTimer::id_t>;
+    timers_t timers_readhits;
+    timers_t timers_clusterhits;
+    timers_t timers_clusters;
+    timers_t timers_eventdata;
+
+    struct stage_timers_t {
+        StageTimer::id_t Updateables = StageTimer::Register("Updateables");
+        StageTimer::id_t ReadHits    = StageTimer::Register("ReadHits hooks");
+        StageTimer::id_t BuildHits   = StageTimer::Register("BuildHits");
+        StageTimer::id_t Clustering  = StageTimer::Register("Clustering");
+        StageTimer::id_t Candidates  = StageTimer::Register("CandidateBuilder");
+    };
+    stage_timers_t stage_timers;
 
     std::unique_ptr<const reconstruct::CandidateBuilder>  candidatebuilder;
     std::unique_ptr<const reconstruct::Clustering_traits> clustering;
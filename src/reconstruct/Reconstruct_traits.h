@@ -29,6 +29,12 @@ struct Reconstruct_traits {
      */
     virtual void DoReconstruct(TEventData& reconstructed) = 0;
 
+    /**
+     * @brief Prefiltered tells if the last DoReconstruct call rejected the event early
+     * @return true if the event should not be processed any further by physics classes
+     */
+    virtual bool Prefiltered() const { return false; }
+
     virtual ~Reconstruct_traits() = default;
 };
 
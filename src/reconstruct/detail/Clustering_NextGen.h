@@ -120,7 +120,8 @@ bump_t merge_bumps(const std::vector<bump_t> bumps) {
 }
 
 void split_cluster(const cluster_t& cluster,
-                          std::vector< cluster_t >& clusters) {
+                   const Detector_t::Geometry_t& geometry,
+                   std::vector< cluster_t >& clusters) {
 
     // make Voting based on relative distance or energy difference
 
@@ -143,18 +144,15 @@ void split_cluster(const cluster_t& cluster,
         while(!reachedMaxEnergy) {
             // find neighbours intersection with actually hit clusters
             reachedMaxEnergy = true;
-            const std::vector<unsigned>& neighbours = cluster[currPos].Element->Neighbours;
+            const unsigned currChannel = cluster[currPos].Element->Channel;
             for(size_t j=0;j<cluster.size();j++) {
-                for(unsigned n=0;n<neighbours.size();n++) {
-                    if(neighbours[n] != cluster[j].Element->Channel)
-                        continue; // cluster element j not neighbour of element currPos, go to next
-                    double energy = cluster[j].Energy;
-                    if(maxEnergy < energy) {
-                        maxEnergy = energy;
-                        currPos = j;
-                        reachedMaxEnergy = false;
-                    }
-                    break; // neighbour indices are unique, stop iterating
+                if(!geometry.IsNeighbour(currChannel, cluster[j].Element->Channel))
+                    continue; // cluster element j not neighbour of element currPos, go to next
+                double energy = cluster[j].Energy;
+                if(maxEnergy < energy) {
+                    maxEnergy = energy;
+                    currPos = j;
+                    reachedMaxEnergy = false;
                 }
             }
         }
@@ -286,19 +284,15 @@ void split_cluster(const cluster_t& cluster,
                 if(state[j].size()>0)
                     continue;
                 for(size_t s=0; s<seeds.size(); s++) {
-                    crystal_t seed = cluster[seeds[s]];
-                    for(size_t n=0;n<seed.Element->Neighbours.size();n++) {
-                        if(seed.Element->Neighbours[n] != cluster[j].Element->Channel)
-                            continue;
-                        // for bump i, we found a next_seed, ...
-                        b_next_seeds[i].emplace_back(j);
-                        // ... and we assign it to this bump
-                        next_state[j].insert(i);
-                        // flag that we found more seeds
-                        noMoreSeeds = false;
-                        // neighbours is a list of unique items, we can stop searching
-                        break;
-                    }
+                    const crystal_t& seed = cluster[seeds[s]];
+                    if(!geometry.IsNeighbour(seed.Element->Channel, cluster[j].Element->Channel))
+                        continue;
+                    // for bump i, we found a next_seed, ...
+                    b_next_seeds[i].emplace_back(j);
+                    // ... and we assign it to this bump
+                    next_state[j].insert(i);
+                    // flag that we found more seeds
+                    noMoreSeeds = false;
                 }
             }
         }
@@ -368,7 +362,8 @@ void split_cluster(const cluster_t& cluster,
 }
 
 void build_cluster(std::list<crystal_t>& crystals,
-                          cluster_t& cluster) {
+                   const Detector_t::Geometry_t& geometry,
+                   cluster_t& cluster) {
     // first crystal has highest energy
     auto i = crystals.begin();
 
@@ -388,20 +383,14 @@ void build_cluster(std::list<crystal_t>& crystals,
         for(const auto& seed : seeds) {
             // find intersection of neighbours and seed
             for(auto j = crystals.begin() ; j != crystals.end() ; ) {
-                bool foundNeighbour = false;
-                for(size_t n=0;n<seed.Element->Neighbours.size();n++) {
-                    if(seed.Element->Neighbours[n] != j->Element->Channel)
-                        continue;
-                    next_seeds.emplace_back(*j);
-                    cluster.emplace_back(*j);
-                    j = crystals.erase(j);
-                    foundNeighbour = true;
-                    // neighbours is a list of unique items, we can stop searching
-                    break;
+                if(!geometry.IsNeighbour(seed.Element->Channel, j->Element->Channel)) {
+                    ++j;
+                    continue;
                 }
+                next_seeds.emplace_back(*j);
+                cluster.emplace_back(*j);
                 // removal moves iterator already one forward
-                if(!foundNeighbour)
-                    ++j;
+                j = crystals.erase(j);
             }
         }
         // set new seeds, if any new found...
@@ -414,14 +403,15 @@ void build_cluster(std::list<crystal_t>& crystals,
 
 void do_clustering(
         std::list<crystal_t>& crystals,
+        const Detector_t::Geometry_t& geometry,
         std::vector< cluster_t >& clusters
         ) {
     crystals.sort();
 
     while(crystals.size()>0) {
         cluster_t cluster;
-        build_cluster(crystals, cluster); // already sorts "cluster" it by energy
-        split_cluster(cluster, clusters);
+        build_cluster(crystals, geometry, cluster); // already sorts "cluster" it by energy
+        split_cluster(cluster, geometry, clusters);
     }
 }
 
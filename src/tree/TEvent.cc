@@ -15,17 +15,13 @@ using namespace ant;
 // use some versioning
 CEREAL_CLASS_VERSION(TEvent, ANT_TEVENT_VERSION)
 
-// tell cereal to use the correct TParticle load/save due to inheritance from LorentzVec
-
-namespace cereal
-{
-  template <class Archive>
-  struct specialize<Archive, TParticle, cereal::specialization::member_load_save> {};
-}
-
 // create some TBuffer to std::streambuf interface
 void TEvent::Streamer(TBuffer& R__b)
 {
+    if(streamed && R__b.IsWriting()) {
+        R__b.WriteFastArray(streamed, Int_t(streamedSize));
+        return;
+    }
     stream_TBuffer::DoBinary(R__b, *this);
 }
 
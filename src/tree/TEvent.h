@@ -8,7 +8,7 @@
 #include <stdexcept>
 #endif
 
-#define ANT_TEVENT_VERSION 4
+#define ANT_TEVENT_VERSION 7
 
 namespace ant {
 
@@ -55,10 +55,24 @@ struct TEvent
     TEvent(TEvent&&);
     TEvent& operator=(TEvent&&);
 
+    /**
+     * @brief SetStreamed lets the Streamer write the given bytes instead of this event
+     * @param data output of an earlier Streamer call, must be valid until written, nullptr to reset
+     * @param size length of data in bytes
+     * @note used to fill trees with events streamed in another process without decoding them
+     */
+    void SetStreamed(const char* data, std::size_t size) {
+        streamed = data;
+        streamedSize = size;
+    }
+
 protected:
     std::unique_ptr<TEventData> reconstructed;
     std::unique_ptr<TEventData> mctrue;
 
+    const char* streamed = nullptr;
+    std::size_t streamedSize = 0;
+
 #endif
 
 public:
@@ -1,8 +1,198 @@
 #include "TEventData.h"
 
+// ignore warnings from library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#include "base/cereal/cereal.hpp"
+#include "base/cereal/types/polymorphic.hpp"
+#include "base/cereal/types/memory.hpp"
+#include "base/cereal/types/string.hpp"
+#include "base/cereal/types/vector.hpp"
+#include "base/cereal/types/list.hpp"
+#include "base/cereal/types/array.hpp"
+#include "base/cereal/types/bitset.hpp"
+#include "base/cereal/archives/binary.hpp"
+#pragma GCC diagnostic pop
+
+#include "base/std_ext/string.h"
+
+#include <istream>
+#include <streambuf>
+
 using namespace std;
 using namespace ant;
 
+// tell cereal to use the correct TParticle load/save due to inheritance from LorentzVec
+
+namespace cereal
+{
+  template <class Archive>
+  struct specialize<Archive, TParticle, cereal::specialization::member_load_save> {};
+}
+
+namespace {
+
+// reads the section in place
+struct membuf_t : std::streambuf {
+    membuf_t(const char* data, size_t size) {
+        auto begin = const_cast<char*>(data);
+        setg(begin, begin, begin+size);
+    }
+    size_t remaining() const { return size_t(egptr()-gptr()); }
+};
+
+// collects the encoded sections, clear() keeps the memory for the next event
+struct vecbuf_t : std::streambuf {
+    vector<char> data;
+    void clear() { data.clear(); }
+protected:
+    streamsize xsputn(const char_type* s, streamsize n) override {
+        data.insert(data.end(), s, s+n);
+        return n;
+    }
+    int_type overflow(int_type ch) override {
+        if(ch != traits_type::eof())
+            data.push_back(traits_type::to_char_type(ch));
+        return ch;
+    }
+};
+
+}
+
+TEventData::Sections_t TEventData::DeferredSections;
+
+TEventData::Sections_t TEventData::AllSections()
+{
+    Sections_t sections;
+    for(unsigned i=0;i<NSections;i++)
+        sections.set(Section_t(i));
+    return sections;
+}
+
+void TEventData::Decode(Sections_t sections)
+{
+    for(unsigned i=0;i<NSections;i++) {
+        const auto section = Section_t(i);
+        if(!sections.test(section) || IsDecoded(section))
+            continue;
+        DecodeSection(section, undecoded[i].data(), undecoded[i].size());
+        undecoded[i] = string(); // release the memory
+        undecodedSections.unset(section);
+    }
+}
+
+void TEventData::save(cereal::BinaryOutputArchive& archive) const
+{
+    // the sizes go first, so encode the decoded sections into one buffer,
+    // which is reused for all events written by this thread
+    thread_local vecbuf_t encoded;
+    encoded.clear();
+    ostream stream(addressof(encoded));
+
+    array<uint32_t, NSections> sizes;
+    array<size_t, NSections> offsets;
+    for(unsigned i=0;i<NSections;i++) {
+        const auto section = Section_t(i);
+        if(IsDecoded(section)) {
+            offsets[i] = encoded.data.size();
+            EncodeSection(section, stream);
+            sizes[i] = encoded.data.size() - offsets[i];
+        }
+        else {
+            sizes[i] = undecoded[i].size();
+        }
+    }
+    archive(ID, sizes);
+    for(unsigned i=0;i<NSections;i++) {
+        if(IsDecoded(Section_t(i)))
+            archive(cereal::binary_data(encoded.data.data()+offsets[i], sizes[i]));
+        else
+            archive(cereal::binary_data(undecoded[i].data(), sizes[i]));
+    }
+}
+
+void TEventData::load(cereal::BinaryInputArchive& archive)
+{
+    array<uint32_t, NSections> sizes;
+    archive(ID, sizes);
+    undecodedSections = Sections_t();
+    string bytes;
+    for(unsigned i=0;i<NSections;i++) {
+        const auto section = Section_t(i);
+        if(DeferredSections.test(section)) {
+            // skip it by its size, decoded later if needed
+            undecoded[i].resize(sizes[i]);
+            archive(cereal::binary_data(&undecoded[i][0], sizes[i]));
+            undecodedSections.set(section);
+        }
+        else {
+            bytes.resize(sizes[i]);
+            archive(cereal::binary_data(&bytes[0], sizes[i]));
+            DecodeSection(section, bytes.data(), bytes.size());
+            undecoded[i].clear();
+        }
+    }
+}
+
+void TEventData::EncodeSection(Section_t section, ostream& stream) const
+{
+    // each section gets its own archive, so it can be decoded on its own
+    cereal::BinaryOutputArchive archive(stream);
+    switch(section) {
+    case Section_t::DetectorReadHits:
+        archive(DetectorReadHits);
+        break;
+    case Section_t::SlowControls:
+        archive(SlowControls);
+        break;
+    case Section_t::UnpackerMessages:
+        archive(UnpackerMessages);
+        break;
+    case Section_t::Tagging:
+        archive(TaggerHits, Trigger, Target);
+        break;
+    case Section_t::Candidates: {
+        // the particle tree is written flat, which is much smaller
+        // than writing all the links between the nodes
+        const FlatTree<TParticlePtr> particleTree(ParticleTree);
+        archive(Clusters, Candidates, particleTree);
+        break;
+    }
+    }
+}
+
+void TEventData::DecodeSection(Section_t section, const char* data, size_t size)
+{
+    membuf_t buf(data, size);
+    istream is(addressof(buf));
+    {
+        cereal::BinaryInputArchive archive(is);
+        switch(section) {
+        case Section_t::DetectorReadHits:
+            archive(DetectorReadHits);
+            break;
+        case Section_t::SlowControls:
+            archive(SlowControls);
+            break;
+        case Section_t::UnpackerMessages:
+            archive(UnpackerMessages);
+            break;
+        case Section_t::Tagging:
+            archive(TaggerHits, Trigger, Target);
+            break;
+        case Section_t::Candidates: {
+            FlatTree<TParticlePtr> particleTree;
+            archive(Clusters, Candidates, particleTree);
+            ParticleTree = particleTree.MakeTree();
+            break;
+        }
+        }
+    }
+    if(buf.remaining() != 0)
+        throw std::runtime_error(std_ext::formatter() << "TEventData section " << unsigned(section)
+                                 << " has " << buf.remaining() << " bytes left after decoding");
+}
+
 TEventData::TEventData(const TID& id) : ID(id) {}
 TEventData::TEventData() {}
 TEventData::~TEventData() {}
@@ -10,6 +200,9 @@ TEventData::~TEventData() {}
 ostream& TEventData::Print(ostream& s) const {
     s << "ID=" << ID << endl;
 
+    if(undecodedSections)
+        s << ">> Some sections not decoded yet" << endl;
+
     s << ">> DetectorReadHits: n=" << DetectorReadHits.size() << endl;
     for(auto& i: DetectorReadHits)
         s << i << endl;
@@ -43,4 +236,7 @@ ostream& TEventData::Print(ostream& s) const {
 void TEventData::ClearDetectorReadHits()
 {
     DetectorReadHits.resize(0);
+    // a deferred section is then just empty
+    undecoded[unsigned(Section_t::DetectorReadHits)].clear();
+    undecodedSections.unset(Section_t::DetectorReadHits);
 }
\ No newline at end of file
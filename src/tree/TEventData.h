@@ -15,6 +15,17 @@
 #include "TCandidate.h"
 #include "TParticle.h"
 
+#include "base/FlatTree.h"
+#include "base/bitflag.h"
+
+#include <array>
+#include <string>
+
+namespace cereal {
+class BinaryOutputArchive;
+class BinaryInputArchive;
+}
+
 namespace ant {
 
 struct TEventData : printable_traits
@@ -36,18 +47,52 @@ struct TEventData : printable_traits
     TCandidateList   Candidates;
     TParticleTree_t  ParticleTree; // only on MC
 
-    template<class Archive>
-    void serialize(Archive& archive) {
-        archive(ID,
-                DetectorReadHits, SlowControls, UnpackerMessages,
-                TaggerHits, Trigger, Target,
-                Clusters, Candidates, ParticleTree);
-    }
+    /**
+     * @brief The Section_t enum lists the parts of TEventData, which are serialised independently
+     *
+     * Clusters, Candidates and ParticleTree share pointers, so they form one section.
+     */
+    enum class Section_t : unsigned {
+        DetectorReadHits,
+        SlowControls,
+        UnpackerMessages,
+        Tagging,    // TaggerHits, Trigger, Target
+        Candidates, // Clusters, Candidates, ParticleTree
+    };
+    static constexpr unsigned NSections = 5;
+    using Sections_t = bitflag<Section_t>;
+    static Sections_t AllSections();
+
+    /**
+     * @brief DeferredSections are not decoded when read, but kept as bytes until Decode() is called
+     *
+     * Members of deferred sections stay empty until then. The PhysicsManager decodes the
+     * sections needed by its physics classes, see Physics::GetNeededSections. Writing the event again
+     * writes the kept bytes unchanged, so nothing is lost if a section was never decoded.
+     */
+    static Sections_t DeferredSections;
+
+    /**
+     * @brief Decode the given sections if they were deferred when read
+     */
+    void Decode(Sections_t sections = AllSections());
+    bool IsDecoded(Section_t section) const { return !undecodedSections.test(section); }
+
+    // written as the ID and a table of the section sizes, followed by the sections,
+    // so deferred sections can be skipped when reading
+    void save(cereal::BinaryOutputArchive& archive) const;
+    void load(cereal::BinaryInputArchive& archive);
 
     virtual std::ostream& Print(std::ostream& s) const override;
 
     void ClearDetectorReadHits();
 
+protected:
+    std::array<std::string, NSections> undecoded;
+    Sections_t undecodedSections;
+
+    void EncodeSection(Section_t section, std::ostream& stream) const;
+    void DecodeSection(Section_t section, const char* data, std::size_t size);
 };
 
 }
\ No newline at end of file
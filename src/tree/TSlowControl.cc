@@ -0,0 +1,51 @@
+#include "TSlowControl.h"
+
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+
+using namespace std;
+using namespace ant;
+
+namespace {
+
+// the registry lives as long as the process,
+// the deque keeps references to the names stable
+struct registry_t {
+    mutex m;
+    unordered_map<string, uint32_t> ids;
+    deque<string> names;
+    registry_t() {
+        names.emplace_back();
+        ids.emplace(names.back(), 0);
+    }
+};
+
+registry_t& registry() {
+    static registry_t r;
+    return r;
+}
+
+}
+
+uint32_t TSlowControl::InternName(const string& name)
+{
+    auto& r = registry();
+    lock_guard<mutex> lock(r.m);
+    auto it = r.ids.find(name);
+    if(it != r.ids.end())
+        return it->second;
+    const auto id = static_cast<uint32_t>(r.names.size());
+    r.names.emplace_back(name);
+    r.ids.emplace(name, id);
+    return id;
+}
+
+const string& TSlowControl::NameFromID(uint32_t id)
+{
+    auto& r = registry();
+    lock_guard<mutex> lock(r.m);
+    if(id >= r.names.size())
+        throw runtime_error("TSlowControl: Unknown name id");
+    return r.names[id];
+}
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <tuple>
+#include <limits>
 
 namespace ant {
 
@@ -26,7 +27,6 @@ struct TSlowControl : printable_traits
     Type_t Type;
     Validity_t Validity;
     std::int64_t Timestamp;   // unix epoch, only meaningful for Type==Epics* items
-    std::string  Name;
     std::string  Description;
 
     std::vector< TKeyValue<std::int64_t> > Payload_Int;
@@ -42,8 +42,9 @@ struct TSlowControl : printable_traits
         Type(type),
         Validity(validity),
         Timestamp(timestamp),
+        Description(description),
         Name(name),
-        Description(description)
+        NameID(InternName(name))
     {
         static_assert(sizeof(decltype(timestamp)) <= sizeof(decltype(Timestamp)),
                       "Bug: type of timestamp too big for TSlowControl"
@@ -52,11 +53,40 @@ struct TSlowControl : printable_traits
     TSlowControl() {}
     virtual ~TSlowControl() {}
 
+    const std::string& GetName() const { return Name; }
+    void SetName(const std::string& name) {
+        Name = name;
+        NameID = InternName(name);
+    }
+
+    // interned Name, see InternName()
+    // comparing this id is much cheaper than comparing the Name
+    std::uint32_t GetNameID() const { return NameID; }
+
+
+    /**
+     * @brief InternName maps the given name to a small id, which is unique within this process
+     * @param name the slowcontrol name
+     * @return the id, the empty name always has id 0
+     */
+    static std::uint32_t InternName(const std::string& name);
+    static const std::string& NameFromID(std::uint32_t id);
+
+    template<class Archive>
+    void save(Archive& archive) const {
+        archive(Type, Validity, Timestamp, Name, Description);
+        save_payload(archive, Payload_Int);
+        save_payload(archive, Payload_Float);
+        save_payload(archive, Payload_String);
+    }
 
     template<class Archive>
-    void serialize(Archive& archive) {
-        archive(Type, Validity, Timestamp, Name, Description,
-                Payload_Int, Payload_Float, Payload_String);
+    void load(Archive& archive) {
+        archive(Type, Validity, Timestamp, Name, Description);
+        load_payload(archive, Payload_Int);
+        load_payload(archive, Payload_Float);
+        load_payload(archive, Payload_String);
+        NameID = InternName(Name);
     }
 
     virtual std::ostream& Print( std::ostream& s) const override {
@@ -106,7 +136,7 @@ struct TSlowControl : printable_traits
             Type(type),
             Name(name)
         {}
-        Key(const TSlowControl& sc) : Key(sc.Type, sc.Name) {}
+        Key(const TSlowControl& sc) : Key(sc.Type, sc.GetName()) {}
         bool operator<(const Key& rhs) const {
             return std::tie(Type, Name) < std::tie(rhs.Type, rhs.Name);
         }
@@ -122,6 +152,108 @@ struct TSlowControl : printable_traits
         return *this;
     }
 
+private:
+
+    // private, so NameID cannot get out of sync
+    std::string   Name;
+    std::uint32_t NameID = 0;
+
+    // the payloads are written packed: the keys are almost always consecutive,
+    // so only the first key is stored then, and the integer values of AcquScalers
+    // usually fit into 32bit
+
+    template<class Archive, typename T>
+    static void save_payload(Archive& archive, const std::vector< TKeyValue<T> >& payload) {
+        bool consecutive = true;
+        for(size_t i=1;i<payload.size();i++) {
+            if(payload[i].Key != payload[i-1].Key+1) {
+                consecutive = false;
+                break;
+            }
+        }
+        archive(consecutive);
+        if(consecutive) {
+            archive(payload.empty() ? std::uint32_t(0) : payload.front().Key);
+        }
+        else {
+            std::vector<std::uint32_t> keys;
+            keys.reserve(payload.size());
+            for(auto& kv : payload)
+                keys.push_back(kv.Key);
+            archive(keys);
+        }
+        save_values(archive, payload);
+    }
+
+    template<class Archive, typename T>
+    static void load_payload(Archive& archive, std::vector< TKeyValue<T> >& payload) {
+        bool consecutive;
+        archive(consecutive);
+        std::uint32_t firstKey = 0;
+        std::vector<std::uint32_t> keys;
+        if(consecutive)
+            archive(firstKey);
+        else
+            archive(keys);
+        std::vector<T> values;
+        load_values(archive, values);
+        if(!consecutive && keys.size() != values.size())
+            throw std::runtime_error("TSlowControl payload corrupt: number of keys and values differ");
+        payload.clear();
+        payload.reserve(values.size());
+        for(size_t i=0;i<values.size();i++)
+            payload.emplace_back(consecutive ? firstKey+i : keys[i], std::move(values[i]));
+    }
+
+    template<class Archive, typename T>
+    static void save_values(Archive& archive, const std::vector< TKeyValue<T> >& payload) {
+        std::vector<T> values;
+        values.reserve(payload.size());
+        for(auto& kv : payload)
+            values.push_back(kv.Value);
+        archive(values);
+    }
+
+    template<class Archive, typename T>
+    static void load_values(Archive& archive, std::vector<T>& values) {
+        archive(values);
+    }
+
+    template<class Archive>
+    static void save_values(Archive& archive, const std::vector< TKeyValue<std::int64_t> >& payload) {
+        using narrow_t = std::uint32_t;
+        bool narrow = true;
+        for(auto& kv : payload) {
+            if(kv.Value < 0 || kv.Value > std::numeric_limits<narrow_t>::max()) {
+                narrow = false;
+                break;
+            }
+        }
+        archive(narrow);
+        if(!narrow) {
+            save_values<Archive, std::int64_t>(archive, payload);
+            return;
+        }
+        std::vector<narrow_t> values;
+        values.reserve(payload.size());
+        for(auto& kv : payload)
+            values.push_back(static_cast<narrow_t>(kv.Value));
+        archive(values);
+    }
+
+    template<class Archive>
+    static void load_values(Archive& archive, std::vector<std::int64_t>& values) {
+        bool narrow;
+        archive(narrow);
+        if(!narrow) {
+            archive(values);
+            return;
+        }
+        std::vector<std::uint32_t> narrow_values;
+        archive(narrow_values);
+        values.assign(narrow_values.begin(), narrow_values.end());
+    }
+
 };
 
 } // namespace ant
@@ -9,6 +9,8 @@
 using namespace std;
 using namespace ant;
 
+bool UnpackerAcqu::ScalersOnly = false;
+
 UnpackerAcqu::UnpackerAcqu() {}
 UnpackerAcqu::~UnpackerAcqu() {}
 
@@ -27,6 +29,7 @@ bool UnpackerAcqu::OpenFile(const std::string &filename)
         return false;
 
     LOG(INFO) << "Successfully opened " << filename;
+    LOG_IF(ScalersOnly, INFO) << "Only scalers will be unpacked, skipping all ADC hits";
     return true;
 }
 
@@ -31,6 +31,14 @@ public:
 
     virtual double PercentDone() const override;
 
+    /**
+     * @brief ScalersOnly switches to a fast path which only decodes scaler, EPICS and
+     * error blocks. ADC hits are skipped without being stored, and only events carrying
+     * TSlowControl or TDAQError items are emitted, which yields a compact scaler time series.
+     * Must be set before the file is opened.
+     */
+    static bool ScalersOnly;
+
 private:
     std::list<TEvent> queue; // std::list supports splice
     std::unique_ptr<UnpackerAcquFileFormat> file;
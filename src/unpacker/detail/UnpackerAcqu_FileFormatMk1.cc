@@ -174,6 +174,13 @@ void acqu::FileFormatMk1::UnpackEvent(TEventData& eventdata, it_t& it, const it_
             HandleDAQError(eventdata.Trigger.DAQErrors, it, it_endbuffer, good);
             break;
         default:
+            if(scalersOnly) {
+                // skip the block of hits at once,
+                // without decoding them
+                it = SkipHits(it, it_endbuffer);
+                good = true;
+                break;
+            }
             // unfortunately, normal hits don't have a marker
             // so we hope for the best at this position in the buffer
             /// \todo Implement better handling of malformed event buffers
@@ -213,7 +220,8 @@ void acqu::FileFormatMk1::UnpackEvent(TEventData& eventdata, it_t& it, const it_
     }
 
     // hit_storage is member variable for better memory allocation performance
-    FillDetectorReadHits(hit_storage, hit_mappings_ptr, eventdata.DetectorReadHits);
+    if(!scalersOnly)
+        FillDetectorReadHits(hit_storage, hit_mappings_ptr, eventdata.DetectorReadHits);
     FillSlowControls(scalers, scaler_mappings, eventdata.SlowControls);
 
     ++it; // go to start word of next event (if any)
@@ -185,6 +185,13 @@ void acqu::FileFormatMk2::UnpackEvent(
             HandleDAQError(eventdata.Trigger.DAQErrors, it, it_endevent, good);
             break;
         default:
+            if(scalersOnly) {
+                // skip the block of hits at once,
+                // without decoding them
+                it = SkipHits(it, it_endevent);
+                good = true;
+                break;
+            }
             // unfortunately, normal hits don't have a marker
             // so we hope for the best at this position in the buffer
             /// \todo Implement better handling of malformed event buffers
@@ -215,7 +222,8 @@ void acqu::FileFormatMk2::UnpackEvent(
     }
 
     // hit_storage is member variable for better memory allocation performance
-    FillDetectorReadHits(hit_storage, hit_mappings_ptr, eventdata.DetectorReadHits);
+    if(!scalersOnly)
+        FillDetectorReadHits(hit_storage, hit_mappings_ptr, eventdata.DetectorReadHits);
     FillSlowControls(scalers, scaler_mappings, eventdata.SlowControls);
 
     it++; // go to start word of next event (if any)
@@ -85,6 +85,8 @@ void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
     reader = move(reader_);
     buffer = move(buffer_);
 
+    scalersOnly = UnpackerAcqu::ScalersOnly;
+
     // let child class fill the info
     FillInfo(reader, buffer, info);
 
@@ -454,15 +456,25 @@ bool acqu::FileFormatBase::UnpackDataBuffer(UnpackerAcquFileFormat::queue_t& que
                 return false;
         }
 
-        if(eventdata.DetectorReadHits.empty()) {
-            LogMessage(TUnpackerMessage::Level_t::Info,
-                       "Unpacked event with completely empty DetectorReadHits",
-                       true // emit warning
-                       );
+        if(scalersOnly) {
+            // keep only the events which carry slowcontrol information,
+            // buffered messages are appended to the next kept event
+            if(eventdata.SlowControls.empty() && eventdata.Trigger.DAQErrors.empty())
+                queue.pop_back();
+            else
+                AppendMessagesToEvent(queue.back());
         }
+        else {
+            if(eventdata.DetectorReadHits.empty()) {
+                LogMessage(TUnpackerMessage::Level_t::Info,
+                           "Unpacked event with completely empty DetectorReadHits",
+                           true // emit warning
+                           );
+            }
 
-        // append the messages to some successfully unpacked event
-        AppendMessagesToEvent(queue.back());
+            // append the messages to some successfully unpacked event
+            AppendMessagesToEvent(queue.back());
+        }
 
         // increment official unique event ID
         ++id;
@@ -498,6 +510,18 @@ bool acqu::FileFormatBase::UnpackDataBuffer(UnpackerAcquFileFormat::queue_t& que
     return true;
 }
 
+acqu::FileFormatBase::it_t acqu::FileFormatBase::SkipHits(it_t it, const it_t& it_end) noexcept
+{
+    // it points to a hit word, and since hits don't have a marker,
+    // advance to the next word which is one of the block markers (or the end of event)
+    return find_if(next(it), it_end, [] (const uint32_t word) {
+        return word == acqu::EEndEvent
+                || word == acqu::EScalerBuffer
+                || word == acqu::EEPICSBuffer
+                || word == acqu::EReadError;
+    });
+}
+
 void acqu::FileFormatBase::FillDetectorReadHits(const hit_storage_t& hit_storage,
                                                 const hit_mappings_ptr_t& hit_mappings_ptr,
                                                 vector<TDetectorReadHit>& hits) noexcept
@@ -112,6 +112,9 @@ protected:
 
     Info info;
 
+    // copied from UnpackerAcqu::ScalersOnly during Setup
+    bool scalersOnly = false;
+
     TID id;
     unsigned AcquID_last = 0;
 
@@ -149,6 +152,7 @@ protected:
 
     std::uint32_t GetDataBufferMarker() const;
     bool SearchFirstDataBuffer(reader_t& reader, buffer_t& buffer, size_t offset) const;
+    static it_t SkipHits(it_t it, const it_t& it_end) noexcept;
     static void FillDetectorReadHits(const hit_storage_t& hit_storage, const hit_mappings_ptr_t& hit_mappings_ptr,
                                      std::vector<TDetectorReadHit>& hits) noexcept;
     static void FillSlowControls(const scalers_t& scalers, const scaler_mappings_t& scaler_mappings,
@@ -24,12 +24,18 @@ using namespace ant::analysis;
 using namespace ant::analysis::input;
 
 void dotest_read_unpacker();
+void dotest_selection_unpacker();
 
 TEST_CASE("AntReader: Read from unpacker", "[analysis]") {
     test::EnsureSetup();
     dotest_read_unpacker();
 }
 
+TEST_CASE("AntReader: Reject entry selection for unpacker", "[analysis]") {
+    test::EnsureSetup();
+    dotest_selection_unpacker();
+}
+
 
 void dotest_read_unpacker() {
     auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
@@ -58,3 +64,20 @@ void dotest_read_unpacker() {
     REQUIRE(nCandidates == 864);
 
 }
+
+void dotest_selection_unpacker() {
+    auto& selection = AntReader::EntrySelection;
+    REQUIRE_FALSE(selection.IsRestricted());
+
+    selection.Shard = 1;
+    selection.Shards = 2;
+    REQUIRE(selection.IsRestricted());
+
+    auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+    REQUIRE_THROWS_AS(AntReader(nullptr, move(unpacker), nullptr), DataReader::Exception);
+
+    selection = AntReader::EntrySelection_t();
+
+    unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+    REQUIRE_NOTHROW(AntReader(nullptr, move(unpacker), nullptr));
+}
@@ -0,0 +1,83 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+
+#include "analysis/physics/AsyncEventWriter.h"
+
+#include "unpacker/Unpacker.h"
+#include "tree/TEvent.h"
+
+#include "base/WrapTFile.h"
+#include "base/tmpfile_t.h"
+
+#include "TTree.h"
+#include "TDirectory.h"
+
+#include <list>
+
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+void dotest_overlap();
+
+TEST_CASE("AsyncEventWriter: Fill while writer is busy", "[analysis]") {
+    test::EnsureSetup();
+    dotest_overlap();
+}
+
+struct AsyncEventWriterTester : AsyncEventWriter {
+    using AsyncEventWriter::AsyncEventWriter;
+    pid_t GetWriter() const { return writer; }
+    int GetPipe() const { return fd; }
+    size_t GetBuffered() const { return buffer.size(); }
+};
+
+void dotest_overlap() {
+    auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+    list<TEvent> events;
+    while(auto event = unpacker->NextEvent())
+        events.emplace_back(move(event));
+    REQUIRE(events.size() == 221);
+
+    tmpfile_t tmpfile;
+    WrapTFileOutput outfile(tmpfile.filename, WrapTFileOutput::mode_t::recreate, true);
+    AsyncEventWriterTester writer(tmpfile.filename, 1);
+
+    // the chunk must fit into the pipe at once
+    const int capacity = fcntl(writer.GetPipe(), F_GETPIPE_SZ);
+    REQUIRE(capacity > 0);
+    REQUIRE(writer.GetChunkSize() <= size_t(capacity));
+
+    // stop the writer, as if it was busy compressing,
+    // and make a blocking write fail instead
+    REQUIRE(kill(writer.GetWriter(), SIGSTOP) == 0);
+    const int flags = fcntl(writer.GetPipe(), F_GETFL);
+    REQUIRE(fcntl(writer.GetPipe(), F_SETFL, flags | O_NONBLOCK) == 0);
+
+    // fill until one chunk was handed over, without the writer reading anything
+    unsigned nFlushes = 0;
+    while(nFlushes == 0) {
+        for(auto& event : events) {
+            const auto buffered = writer.GetBuffered();
+            REQUIRE_NOTHROW(writer.Fill(event));
+            if(writer.GetBuffered() < buffered) {
+                nFlushes++;
+                break;
+            }
+        }
+    }
+    REQUIRE(writer.GetBuffered() > 0);
+
+    REQUIRE(fcntl(writer.GetPipe(), F_SETFL, flags) == 0);
+    REQUIRE(kill(writer.GetWriter(), SIGCONT) == 0);
+
+    const auto nEntries = writer.GetEntries();
+    TTree* tree = writer.Finish(*gDirectory);
+    REQUIRE(tree != nullptr);
+    REQUIRE(tree->GetEntries() == Long64_t(nEntries));
+}
@@ -0,0 +1,136 @@
+#include "catch.hpp"
+#include "catch_config.h"
+
+#include "analysis/utils/EventDiff.h"
+
+#include "tree/TEventData.h"
+#include "base/std_ext/math.h"
+#include "base/std_ext/memory.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+void dotest_identical();
+void dotest_tolerance();
+void dotest_fields();
+void dotest_merge();
+
+TEST_CASE("EventDiff: Identical", "[analysis]") {
+    dotest_identical();
+}
+
+TEST_CASE("EventDiff: Tolerance", "[analysis]") {
+    dotest_tolerance();
+}
+
+TEST_CASE("EventDiff: Fields", "[analysis]") {
+    dotest_fields();
+}
+
+TEST_CASE("EventDiff: Merge", "[analysis]") {
+    dotest_merge();
+}
+
+unique_ptr<TEventData> make_data(unsigned i) {
+    auto data = std_ext::make_unique<TEventData>(TID(i));
+    data->Trigger.DAQEventID = i;
+    data->Trigger.CBEnergySum = 500.0+i;
+    data->TaggerHits.emplace_back(10, 1400.0, 1.5);
+    data->TaggerHits.emplace_back(20, 1200.0, std_ext::NaN);
+    return data;
+}
+
+void dotest_identical() {
+    EventDiff diff;
+    for(unsigned i=0;i<10;i++)
+        REQUIRE(diff.CompareData(*make_data(i), *make_data(i)));
+    const auto& summary = diff.GetSummary();
+    CHECK(summary.Identical());
+    CHECK(summary.Compared == 10);
+    CHECK(summary.Fields.empty());
+}
+
+void dotest_tolerance() {
+    auto a = make_data(1);
+    auto b = make_data(1);
+    b->TaggerHits.front().PhotonEnergy += 1e-6;
+
+    EventDiff exact;
+    CHECK_FALSE(exact.CompareData(*a, *b));
+
+    EventDiff::Options_t abs;
+    abs.AbsTolerance = 1e-5;
+    EventDiff with_abs(abs);
+    CHECK(with_abs.CompareData(*a, *b));
+
+    EventDiff::Options_t rel;
+    rel.RelTolerance = 1e-8;
+    EventDiff with_rel(rel);
+    CHECK(with_rel.CompareData(*a, *b));
+
+    // NaN only equals NaN
+    b = make_data(1);
+    b->TaggerHits.back().Time = 0;
+    EventDiff nan(abs);
+    CHECK_FALSE(nan.CompareData(*a, *b));
+}
+
+void dotest_fields() {
+    EventDiff::Options_t options;
+    options.MaxExamples = 3;
+    EventDiff diff(options);
+
+    for(unsigned i=0;i<10;i++) {
+        auto a = make_data(i);
+        auto b = make_data(i);
+        // two differences in the same field count as one event
+        b->TaggerHits[0].Channel++;
+        b->TaggerHits[1].Channel++;
+        if(i % 2 == 0)
+            b->TaggerHits.pop_back();
+        REQUIRE_FALSE(diff.CompareData(*a, *b));
+    }
+    diff.AddOnlyFirst(TID(100));
+
+    const auto& summary = diff.GetSummary();
+    CHECK_FALSE(summary.Identical());
+    CHECK(summary.Compared == 10);
+    CHECK(summary.Differing == 10);
+    CHECK(summary.OnlyFirst == 1);
+
+    const auto& channel = summary.Fields.at("Reconstructed.TaggerHits[].Channel");
+    CHECK(channel.Events == 10);
+    REQUIRE(channel.Examples.size() == 3);
+    CHECK(channel.Examples.front().find("TaggerHits[0].Channel: 10 != 11") != string::npos);
+
+    const auto& size = summary.Fields.at("Reconstructed.TaggerHits.size");
+    CHECK(size.Events == 5);
+
+    CHECK(summary.Fields.count("Reconstructed.Trigger.DAQEventID") == 0);
+}
+
+void dotest_merge() {
+    EventDiff::Options_t options;
+    options.MaxExamples = 2;
+
+    auto run = [options] (unsigned begin, unsigned end) {
+        EventDiff diff(options);
+        for(unsigned i=begin;i<end;i++) {
+            auto b = make_data(i);
+            b->Trigger.CBEnergySum = 0;
+            diff.CompareData(*make_data(i), *b);
+        }
+        return diff.GetSummary();
+    };
+
+    auto summary = run(0, 1);
+    summary.Merge(run(1, 5), options.MaxExamples);
+    const auto all = run(0, 5);
+
+    CHECK(summary.Compared == all.Compared);
+    CHECK(summary.Differing == all.Differing);
+    const auto& field = summary.Fields.at("Reconstructed.Trigger.CBEnergySum");
+    CHECK(field.Events == 5);
+    CHECK(field.Examples == all.Fields.at("Reconstructed.Trigger.CBEnergySum").Examples);
+}
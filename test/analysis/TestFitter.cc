@@ -22,6 +22,7 @@ using namespace ant::analysis;
 using namespace ant::analysis::input;
 
 void dotest(bool, bool, bool);
+void dotest_beamEs(bool);
 
 TEST_CASE("Fitter: Ideal KinFitter, z vertex fixed, proton measured", "[analysis]") {
     dotest(false, false, false);
@@ -39,6 +40,14 @@ TEST_CASE("Fitter: Ideal KinFitter, z vertex free, proton UNmeasured", "[analysi
     dotest(true, true, false);
 }
 
+TEST_CASE("Fitter: KinFitter with several beam energies, proton measured", "[analysis]") {
+    dotest_beamEs(false);
+}
+
+TEST_CASE("Fitter: KinFitter with several beam energies, proton UNmeasured", "[analysis]") {
+    dotest_beamEs(true);
+}
+
 //TEST_CASE("Fitter: Smeared KinFitter, z vertex fixed, proton measured", "[analysis]") {
 //    dotest(false, false, true);
 //}
@@ -379,3 +388,82 @@ void dotest(bool z_vertex, bool proton_unmeas, bool smeared) {
         CHECK(IM_2g_after.GetRMS() == Approx(0).epsilon(0.01).scale(100));
     }
 }
+
+void dotest_beamEs(bool proton_unmeas) {
+    test::EnsureSetup();
+
+    auto rootfile = make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/Pluto_Etap2g.root");
+    PlutoReader reader(rootfile);
+
+    auto model = make_shared<TestUncertaintyModel>(proton_unmeas);
+
+    utils::KinFitter kinfitter("kinfitter", 2, model, true);
+    kinfitter.SetZVertexSigma(3.0);
+
+    utils::MCFakeReconstructed mc_fake(true);
+    utils::MCSmear mc_smear(model);
+
+    unsigned nEvents = 0;
+    unsigned nFits = 0;
+
+    while(nEvents<100) {
+        event_t event;
+        if(!reader.ReadNextEvent(event))
+            break;
+        nEvents++;
+
+        INFO("nEvents="+to_string(nEvents));
+
+        auto mctrue_particles = mc_fake.Get(event.MCTrue());
+
+        TParticlePtr beam = event.MCTrue().ParticleTree->Get();
+        TParticlePtr proton = mc_smear.Smear(mctrue_particles.Get(ParticleTypeDatabase::Proton).front());
+        TParticleList photons = mc_smear.Smear(mctrue_particles.Get(ParticleTypeDatabase::Photon));
+
+        // mimic some tagger hits around the true beam energy
+        const vector<double> ebeams{beam->Ek()-30, beam->Ek(), beam->Ek()+10, beam->Ek()-5};
+
+        // fit each beam energy separately as reference
+        struct fitted_t {
+            APLCON::Result_t Result;
+            double BeamE;
+            double ZVertex;
+            LorentzVec Proton;
+        };
+        vector<fitted_t> expected;
+        for(auto ebeam : ebeams) {
+            auto r = kinfitter.DoFit(ebeam, proton, photons);
+            expected.push_back({r, kinfitter.GetFittedBeamE(),
+                                kinfitter.GetFittedZVertex(), *kinfitter.GetFittedProton()});
+        }
+
+        unsigned nCalls = 0;
+        kinfitter.DoFits(ebeams, proton, photons,
+                         [&] (unsigned i, const APLCON::Result_t& r) {
+            REQUIRE(i == nCalls);
+            nCalls++;
+            nFits++;
+            const auto& e = expected.at(i);
+            REQUIRE(r.Status == e.Result.Status);
+            REQUIRE(r.NIterations == e.Result.NIterations);
+            REQUIRE(r.ChiSquare == e.Result.ChiSquare);
+            REQUIRE(kinfitter.GetFittedBeamE() == e.BeamE);
+            REQUIRE(kinfitter.GetFittedZVertex() == e.ZVertex);
+            REQUIRE(*kinfitter.GetFittedProton() == e.Proton);
+            return true;
+        });
+        REQUIRE(nCalls == ebeams.size());
+
+        // stop early as soon as one fit is good enough
+        nCalls = 0;
+        kinfitter.DoFits(ebeams, proton, photons,
+                         [&nCalls] (unsigned, const APLCON::Result_t&) {
+            nCalls++;
+            return nCalls < 2;
+        });
+        REQUIRE(nCalls == 2);
+    }
+
+    CHECK(nEvents == 100);
+    CHECK(nFits == 400);
+}
@@ -3,12 +3,15 @@
 #include "analysis/plot/HistogramFactory.h"
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
+#include "base/std_ext/math.h"
+#include "base/OutputProfile.h"
 
 #include "TH1D.h"
 #include "TH2D.h"
 #include "TH3D.h"
 #include "TGraph.h"
 #include "TTree.h"
+#include "TBranch.h"
 
 using namespace std;
 using namespace ant;
@@ -17,6 +20,8 @@ using namespace ant::analysis;
 void dotest_make();
 void dotest_nameclash();
 void dotest_numdir();
+void dotest_channelhistbank();
+void dotest_treeprofile();
 
 
 TEST_CASE("HistogramFactory: Make", "[analysis]") {
@@ -33,6 +38,15 @@ TEST_CASE("HistogramFactory: Numbered directories", "[analysis]") {
 }
 
 
+TEST_CASE("HistogramFactory: ChannelHistBank", "[analysis]") {
+    dotest_channelhistbank();
+}
+
+TEST_CASE("HistogramFactory: Output profile of trees", "[analysis]") {
+    dotest_treeprofile();
+}
+
+
 void dotest_make() {
     gDirectory->Clear();
 
@@ -88,3 +102,83 @@ void dotest_numdir() {
     // back in old dir
     REQUIRE(dynamic_cast<TDirectory*>(gDirectory->FindObject("Test_2")));
 }
+
+void dotest_channelhistbank() {
+    gDirectory->Clear();
+
+    HistogramFactory h("Test");
+
+    const BinSettings xbins(100,-10,30);
+    const BinSettings channels(20);
+    auto bank = h.makeChannelHistBank("bank","x","channel",xbins,channels,"bank");
+    auto ref  = h.makeTH2D("ref","x","channel",xbins,channels,"ref");
+
+    REQUIRE(bank);
+    REQUIRE(string(bank.Hist()->GetName()) == "bank");
+    REQUIRE(bank.Hist()->GetNbinsX() == ref->GetNbinsX());
+
+    // include values at the edges, outside and NaN
+    vector<double> xs{-10, -10.1, 30, 29.99, 0, 0.4, 1.0/3, 17.5, std_ext::NaN};
+    for(int i=0;i<1000;i++)
+        xs.push_back(-15+50*i/1000.0);
+    vector<double> ys{-1, 0, 19, 19.5, 20, 25, 7};
+
+    auto fill = [&] () {
+        for(auto x : xs) {
+            for(auto y : ys) {
+                bank.Fill(x, y);
+                ref->Fill(x, y);
+            }
+        }
+    };
+
+    auto check = [&] () {
+        const TH2D* hbank = bank.Hist();
+        REQUIRE(hbank->GetEntries() == ref->GetEntries());
+        for(int bin=0;bin<ref->GetSize();bin++)
+            REQUIRE(hbank->GetBinContent(bin) == ref->GetBinContent(bin));
+        double stats_bank[TH1::kNstat] = {};
+        double stats_ref[TH1::kNstat] = {};
+        hbank->GetStats(stats_bank);
+        ref->GetStats(stats_ref);
+        for(int i=0;i<7;i++)
+            REQUIRE(stats_bank[i] == Approx(stats_ref[i]));
+    };
+
+    fill();
+    check();
+
+    // flushing again adds to the histogram
+    fill();
+    check();
+}
+
+void dotest_treeprofile() {
+    const auto& fast = OutputProfile::Get("fast");
+    OutputProfile::Select("archive");
+    OutputProfile::SelectForTree("tree", "fast");
+
+    tmpfile_t tmpfile;
+    {
+        WrapTFileOutput outfile(tmpfile.filename, WrapTFileOutput::mode_t::recreate, true);
+        HistogramFactory h("Test");
+        auto tree = h.makeTTree("tree");
+
+        // branches are created after makeTTree, as most physics classes do
+        double x = 0;
+        tree->Branch("x", addressof(x));
+        tree->Fill();
+
+        auto branch = tree->GetBranch("x");
+        CHECK(branch->GetCompressionSettings() == fast.GetCompressionSettings());
+        CHECK(branch->GetBasketSize() == fast.BasketSize);
+        CHECK(tree->GetAutoFlush() == fast.AutoFlush);
+    }
+    OutputProfile::Reset();
+
+    // still a plain TTree in the file
+    WrapTFileInput infile(tmpfile.filename);
+    TTree* tree = nullptr;
+    REQUIRE(infile.GetObject("Test/tree", tree));
+    REQUIRE(tree->GetEntries() == 1);
+}
@@ -11,6 +11,9 @@
 #include <cassert>
 #include "analysis/utils/matcher.h"
 
+#include <random>
+#include <list>
+
 
 using namespace std;
 using namespace ant;
@@ -75,3 +78,74 @@ TEST_CASE("Matcher2: va < vb", "[analysis]") {
 
     test_matcher2(va, vb, exp);
 }
+
+// the former implementation of match1to1, as reference
+template <class MatchFunction, typename List1, typename List2>
+std::list< utils::scored_match<typename List1::value_type, typename List2::value_type> >
+    match1to1_reference( const List1& list1,
+                         const List2& list2,
+                         MatchFunction f,
+                         const IntervalD& score_window)
+{
+    typedef typename List1::value_type T1;
+    typedef typename List2::value_type T2;
+    std::list< utils::scored_match<T1, T2> > scores;
+
+    for( const auto& i : list1 )
+        for( const auto& j : list2 ) {
+            const double score = f(i,j);
+            if( score_window.Contains(score)) {
+                utils::scored_match<T1,T2> s = {score,i,j};
+                scores.emplace_back(s);
+            }
+        }
+
+    scores.sort();
+
+    auto i = scores.begin();
+    while(  i != scores.end() ) {
+        auto j = i;
+        ++j;
+        while( j!=scores.end() ) {
+            if( j->a == i->a || j->b == i->b)
+                j = scores.erase(j);
+            else
+                ++j;
+        }
+        ++i;
+    }
+
+    return scores;
+}
+
+TEST_CASE("Matcher: match1to1 as before", "[analysis]") {
+
+    std::mt19937 rng(42);
+    // small values give many equal scores and duplicate elements
+    std::uniform_int_distribution<int> value(0, 20);
+    std::uniform_int_distribution<int> size(0, 8);
+
+    auto f = [] (const int a, const int b) { return utils::matchDistance(a, b); };
+
+    for(int n=0;n<10000;n++) {
+        vector<int> va(size(rng));
+        vector<int> vb(size(rng));
+        for(auto& v : va)
+            v = value(rng);
+        for(auto& v : vb)
+            v = value(rng);
+        const IntervalD window(0, n % 2 ? 5 : std_ext::inf);
+
+        const auto expected = match1to1_reference(va, vb, f, window);
+        const auto res = utils::match1to1(va, vb, f, window);
+
+        REQUIRE(res.size() == expected.size());
+        auto it_exp = expected.begin();
+        for(const auto& m : res) {
+            REQUIRE(m.score == it_exp->score);
+            REQUIRE(m.a == it_exp->a);
+            REQUIRE(m.b == it_exp->b);
+            ++it_exp;
+        }
+    }
+}
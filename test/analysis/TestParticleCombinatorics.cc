@@ -0,0 +1,124 @@
+#include "catch.hpp"
+
+#include "analysis/utils/combinatorics.h"
+#include "analysis/utils/particle_tools.h"
+#include "base/ParticleType.h"
+#include "tree/TParticle.h"
+
+#include <random>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::utils;
+
+void dotest_table();
+void dotest_imcombinations();
+void dotest_fillimcombinations();
+
+TEST_CASE("ParticleCombinatorics: KofNtable", "[analysis]") {
+    dotest_table();
+}
+
+TEST_CASE("ParticleCombinatorics: IMCombinations", "[analysis]") {
+    dotest_imcombinations();
+}
+
+TEST_CASE("ParticleCombinatorics: FillIMCombinations", "[analysis]") {
+    dotest_fillimcombinations();
+}
+
+TParticleList make_photons(unsigned n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> angle(0.1, 3.0);
+    std::uniform_real_distribution<double> energy(10.0, 800.0);
+    TParticleList photons;
+    for(unsigned i=0;i<n;i++)
+        photons.emplace_back(make_shared<TParticle>(ParticleTypeDatabase::Photon,
+                                                    energy(rng), angle(rng), 2*angle(rng)));
+    return photons;
+}
+
+void dotest_table() {
+    const vector<int> data{0, 1, 2, 3, 4, 5, 6};
+
+    for(unsigned k=0;k<=data.size()+1;k++) {
+        const auto& table = KofNtable::Get(data.size(), k);
+        REQUIRE(table.n() == data.size());
+        REQUIRE(table.k() == k);
+        // cached instance is returned
+        REQUIRE(&table == &KofNtable::Get(data.size(), k));
+
+        size_t c = 0;
+        for(auto comb = makeCombination(data, k); !comb.Done(); ++comb) {
+            REQUIRE(c < table.size());
+            unsigned i = 0;
+            KofNtable::mask_type mask = 0;
+            for(auto d : comb) {
+                REQUIRE(table.Index(c, i) == unsigned(d));
+                mask |= 1 << d;
+                i++;
+            }
+            REQUIRE(table.Masks().at(c) == mask);
+            c++;
+        }
+        REQUIRE(c == table.size());
+    }
+
+    // n=7, k=3
+    REQUIRE(KofNtable::Get(7, 3).size() == 35);
+    REQUIRE(KofNtable::Get(7, 8).size() == 0);
+}
+
+void dotest_imcombinations() {
+    std::mt19937 rng(42);
+    IMCombinations im_combinations;
+
+    for(unsigned n=0;n<=8;n++) {
+        const auto photons = make_photons(n, rng);
+        for(unsigned k=1;k<=n;k++) {
+            const auto& ims = im_combinations.Calc(photons, k);
+            REQUIRE(ims.size() == im_combinations.Table().size());
+            size_t c = 0;
+            for(auto comb = makeCombination(photons, k); !comb.Done(); ++comb) {
+                LorentzVec sum({0,0,0},0);
+                for(const auto& p : comb)
+                    sum += *p;
+                // summed in the same order, so exactly equal
+                REQUIRE(ims.at(c) == sum.M());
+                c++;
+            }
+            REQUIRE(c == ims.size());
+        }
+    }
+
+    // plain LorentzVec's work as well
+    const vector<LorentzVec> vecs{ {{0,0,100},100}, {{0,0,-100},100} };
+    const auto& ims = im_combinations.Calc(vecs, 2);
+    REQUIRE(ims.size() == 1);
+    REQUIRE(ims.front() == Approx(200.0));
+}
+
+void dotest_fillimcombinations() {
+    std::mt19937 rng(7);
+    const auto photons = make_photons(6, rng);
+
+    vector<double> filled;
+    ParticleTools::FillIMCombinations([&filled] (double im) { filled.push_back(im); }, 2, photons);
+    REQUIRE(filled.size() == 15);
+
+    size_t c = 0;
+    for(auto comb = makeCombination(photons, 2); !comb.Done(); ++comb) {
+        REQUIRE(filled.at(c) == (*comb.at(0) + *comb.at(1)).M());
+        c++;
+    }
+
+    // not_indices are the complement of the drawn elements
+    for(auto comb = makeCombination(photons, 4); !comb.Done(); ++comb) {
+        unsigned n_drawn = 0;
+        for(auto it = comb.begin(); it != comb.end(); ++it)
+            n_drawn++;
+        unsigned n_not = 0;
+        for(auto it = comb.begin_not(); it != comb.end_not(); ++it)
+            n_not++;
+        REQUIRE(n_drawn + n_not == photons.size());
+    }
+}
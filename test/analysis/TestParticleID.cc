@@ -5,6 +5,7 @@
 #include "analysis/utils/root-addons.h"
 
 #include "TCutG.h"
+#include "TRandom3.h"
 
 #include <cassert>
 #include <iostream>
@@ -35,6 +36,8 @@ void test_electoncut();
 void test_electonantprotoncut();
 void test_tof();
 void test_tofdee();
+void test_compiledcut();
+void test_compiledpid();
 
 
 struct testdata {
@@ -75,6 +78,14 @@ TEST_CASE("ParticleID: tof + dEE cut", "[analysis]") {
     test_tofdee();
 }
 
+TEST_CASE("ParticleID: CompiledCutG", "[analysis]") {
+    test_compiledcut();
+}
+
+TEST_CASE("ParticleID: CompiledParticleID", "[analysis]") {
+    test_compiledpid();
+}
+
 void test_makeTCutG() {
     auto cut = root::makeTCutG("a", {{1,1},{3,1},{3,3},{1,3}});
     REQUIRE(cut->IsInside(2,2));
@@ -157,6 +168,66 @@ void test_tofdee() {
 
 
 
+void test_compiledcut() {
+    // some non-convex polygon with duplicate points and horizontal edges
+    auto cut = root::makeTCutG("weird", {{0,0},{10,0},{10,10},{5,2},{5,2},{0,10},{2,5},{0,5}});
+    TRandom3 rng(1234);
+
+    for(unsigned nSlabs : {1u, 3u, 32u, 1000u}) {
+        CompiledCutG compiled(*cut, nSlabs);
+        unsigned nInside = 0;
+        for(unsigned i=0;i<10000;i++) {
+            const double x = rng.Uniform(-1, 11);
+            const double y = rng.Uniform(-1, 11);
+            const bool expected = cut->IsInside(x, y);
+            REQUIRE(compiled.IsInside(x, y) == expected);
+            if(expected)
+                nInside++;
+        }
+        // also check exactly on vertices and edges
+        for(int i=0;i<cut->GetN();i++) {
+            const double x = cut->GetX()[i];
+            const double y = cut->GetY()[i];
+            REQUIRE(compiled.IsInside(x, y) == bool(cut->IsInside(x, y)));
+            REQUIRE(compiled.IsInside(x, 5) == bool(cut->IsInside(x, 5)));
+        }
+        REQUIRE(nInside > 0);
+        REQUIRE_FALSE(compiled.IsInside(std_ext::NaN, 5));
+    }
+}
+
+void test_compiledpid() {
+    BasicParticleID pid;
+    pid.dEE_electron = data.dEE_electron;
+    pid.dEE_proton = data.dEE_proton;
+    pid.tof = data.tofcut;
+
+    CompiledParticleID compiled(pid);
+
+    REQUIRE(compiled.Identify(data.gamma)   == &ParticleTypeDatabase::Photon);
+    REQUIRE(compiled.Identify(data.proton)  == &ParticleTypeDatabase::Proton);
+    REQUIRE(compiled.Identify(data.neutron) == &ParticleTypeDatabase::Neutron);
+    REQUIRE(compiled.Identify(data.electron)== &ParticleTypeDatabase::eCharged);
+
+    // batch identification gives same as single
+    TCandidateList cands;
+    TRandom3 rng(4321);
+    for(unsigned i=0;i<1000;i++) {
+        cands.emplace_back(Detector_t::Type_t::CB,
+                           rng.Uniform(0, 400), 0, 0,
+                           rng.Uniform(0, 20), 0,
+                           rng.Uniform() < 0.2 ? 0.0 : rng.Uniform(0, 20),
+                           0, TClusterList{});
+    }
+
+    ParticleID::types_t types;
+    compiled.IdentifyAll(cands, types);
+    REQUIRE(types.size() == cands.size());
+    for(unsigned i=0;i<cands.size();i++) {
+        REQUIRE(types[i] == pid.Identify(cands.get_ptr_at(i)));
+    }
+}
+
 testdata::testdata()
 {
     // set up cuts
@@ -4,6 +4,8 @@
 
 #include "analysis/physics/PhysicsManager.h"
 #include "analysis/input/ant/AntReader.h"
+#include "analysis/input/ant/EventList.h"
+#include "analysis/input/ant/CalibrationCache.h"
 #include "analysis/input/pluto/PlutoReader.h"
 
 #include "analysis/utils/Uncertainties.h"
@@ -17,6 +19,7 @@
 
 #include "base/tmpfile_t.h"
 #include "base/WrapTFile.h"
+#include "base/std_ext/string.h"
 
 #include "TTree.h"
 
@@ -24,15 +27,23 @@
 #include <iostream>
 #include <list>
 
+#include <unistd.h>
+
 using namespace std;
 using namespace ant;
 using namespace ant::analysis;
 
 void dotest_raw();
 void dotest_raw_nowrite();
+void dotest_asyncsave();
 void dotest_plutogeant();
 void dotest_pluto();
 void dotest_runall();
+void dotest_eventlist();
+void dotest_eventlist_mctrue();
+void dotest_calibrationcache();
+void dotest_multifile();
+void dotest_neededsections();
 
 TEST_CASE("PhysicsManager: Raw Input", "[analysis]") {
     test::EnsureSetup();
@@ -44,6 +55,11 @@ TEST_CASE("PhysicsManager: Raw Input without TEvent writing", "[analysis]") {
     dotest_raw_nowrite();
 }
 
+TEST_CASE("PhysicsManager: Async saving of TEvents", "[analysis]") {
+    test::EnsureSetup();
+    dotest_asyncsave();
+}
+
 TEST_CASE("PhysicsManager: Pluto/Geant Input", "[analysis]") {
     test::EnsureSetup();
     dotest_plutogeant();
@@ -54,6 +70,31 @@ TEST_CASE("PhysicsManager: Pluto only Input", "[analysis]") {
     dotest_pluto();
 }
 
+TEST_CASE("PhysicsManager: Event lists", "[analysis]") {
+    test::EnsureSetup();
+    dotest_eventlist();
+}
+
+TEST_CASE("PhysicsManager: Event lists of MC only events", "[analysis]") {
+    test::EnsureSetup();
+    dotest_eventlist_mctrue();
+}
+
+TEST_CASE("PhysicsManager: Calibration cache", "[analysis]") {
+    test::EnsureSetup();
+    dotest_calibrationcache();
+}
+
+TEST_CASE("PhysicsManager: Multiple treeEvents files", "[analysis]") {
+    test::EnsureSetup();
+    dotest_multifile();
+}
+
+TEST_CASE("PhysicsManager: Decode needed sections", "[analysis]") {
+    test::EnsureSetup();
+    dotest_neededsections();
+}
+
 TEST_CASE("PhysicsManager: Run all physics", "[analysis]") {
     test::EnsureSetup();
     dotest_runall();
@@ -103,6 +144,36 @@ struct TestPhysics : Physics
     }
 };
 
+struct SectionsPhysics : Physics
+{
+    const TEventData::Sections_t needed;
+    const bool save;
+    unsigned& seenReadHits;
+    unsigned& seenCandidates;
+
+    SectionsPhysics(const string& name, TEventData::Sections_t needed_, bool save_,
+                    unsigned& seenReadHits_, unsigned& seenCandidates_) :
+        Physics(name, nullptr),
+        needed(needed_), save(save_),
+        seenReadHits(seenReadHits_), seenCandidates(seenCandidates_)
+    {}
+
+    virtual void ProcessEvent(const TEvent& event, physics::manager_t& manager) override
+    {
+        seenReadHits += event.Reconstructed().DetectorReadHits.size();
+        seenCandidates += event.Reconstructed().Candidates.size();
+        if(save) {
+            manager.SaveEvent();
+            manager.KeepDetectorReadHits();
+        }
+    }
+
+    virtual TEventData::Sections_t GetNeededSections() const override
+    {
+        return needed;
+    }
+};
+
 struct PhysicsManagerTester : PhysicsManager
 {
     using PhysicsManager::PhysicsManager;
@@ -216,6 +287,250 @@ void dotest_raw()
 
 }
 
+void dotest_asyncsave()
+{
+    const unsigned expectedEvents = 221;
+
+    tmpfile_t tmpfile;
+
+    PhysicsManager::AsyncSaveEvents = true;
+    {
+        WrapTFileOutput outfile(tmpfile.filename, WrapTFileOutput::mode_t::recreate, true);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>();
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(nullptr, move(unpacker), std_ext::make_unique<Reconstruct>()));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+
+        auto tree = outfile.GetSharedClone<TTree>("treeEvents");
+        REQUIRE(tree != nullptr);
+        REQUIRE(tree->GetEntries() == expectedEvents/3);
+    }
+    PhysicsManager::AsyncSaveEvents = false;
+
+    // the temporary file of the writer is removed
+    const string writerfile = std_ext::formatter() << tmpfile.filename << ".treeEvents." << getpid() << ".tmp";
+    REQUIRE(access(writerfile.c_str(), F_OK) != 0);
+
+    // the copied events read back the same as the synchronously written ones
+    {
+        auto inputfiles = make_shared<WrapTFileInput>(tmpfile.filename);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>();
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+
+        std::shared_ptr<TestPhysics> physics = pm.GetTestPhysicsModule();
+        REQUIRE(physics->seenEvents == expectedEvents/3);
+        REQUIRE(physics->seenCandidates == 286);
+    }
+}
+
+void dotest_eventlist()
+{
+    const unsigned expectedEvents = 221;
+
+    // a file with some TEvents as starting point
+    tmpfile_t tmpfile_events;
+    {
+        WrapTFileOutput outfile(tmpfile_events.filename, WrapTFileOutput::mode_t::recreate, true);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>();
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(nullptr, move(unpacker), std_ext::make_unique<Reconstruct>()));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    }
+
+    PhysicsManager::SaveEventLists = true;
+
+    // skim it into an event list, and skim that list again
+    tmpfile_t tmpfile_list1;
+    tmpfile_t tmpfile_list2;
+    unsigned expectedSkimmed = expectedEvents/3;
+    for(auto files : {make_pair(&tmpfile_events, &tmpfile_list1),
+                      make_pair(&tmpfile_list1, &tmpfile_list2)})
+    {
+        {
+            WrapTFileOutput outfile(files.second->filename, WrapTFileOutput::mode_t::recreate, true);
+            auto inputfiles = make_shared<WrapTFileInput>(files.first->filename);
+            PhysicsManagerTester pm;
+            pm.AddPhysics<TestPhysics>();
+            list< unique_ptr<analysis::input::DataReader> > readers;
+            readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr));
+            pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+
+            std::shared_ptr<TestPhysics> physics = pm.GetTestPhysicsModule();
+            REQUIRE(physics->seenEvents == expectedSkimmed);
+            expectedSkimmed /= 3;
+        }
+
+        WrapTFileInput outfile(files.second->filename);
+        TTree* tree = nullptr;
+        REQUIRE_FALSE(outfile.GetObject("treeEvents", tree));
+        input::EventList_t eventlist;
+        REQUIRE(outfile.GetObject(input::EventList_t::TreeName, eventlist.Tree));
+        REQUIRE(eventlist.Tree->GetEntries() == expectedSkimmed);
+        // chained skims still refer to the original file
+        const auto sources = eventlist.GetSources();
+        REQUIRE(sources.size() == 1);
+        REQUIRE(sources.front().find(tmpfile_events.filename.substr(tmpfile_events.filename.rfind('/'))) != string::npos);
+    }
+
+    PhysicsManager::SaveEventLists = false;
+
+    // replay the chained event list
+    auto inputfiles = make_shared<WrapTFileInput>(tmpfile_list2.filename);
+    PhysicsManagerTester pm;
+    pm.AddPhysics<TestPhysics>(true);
+    list< unique_ptr<analysis::input::DataReader> > readers;
+    readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr));
+    pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    TAntHeader header;
+    pm.SetAntHeader(header);
+
+    // every third of every third of every third event
+    const std::uint32_t timestamp = 1408221194;
+    REQUIRE(header.FirstID == TID(timestamp, 26u));
+    std::shared_ptr<TestPhysics> physics = pm.GetTestPhysicsModule();
+    REQUIRE(physics->seenEvents == expectedEvents/27);
+}
+
+void dotest_eventlist_mctrue()
+{
+    // MC only treeEvents from pluto, every third event saved
+    tmpfile_t tmpfile_events;
+    {
+        WrapTFileOutput outfile(tmpfile_events.filename, WrapTFileOutput::mode_t::recreate, true);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>();
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        auto plutofile = std::make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/Pluto_with_TID.root");
+        readers.push_back(std_ext::make_unique<analysis::input::PlutoReader>(plutofile));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    }
+
+    // skim it into an event list
+    PhysicsManager::SaveEventLists = true;
+    tmpfile_t tmpfile_list;
+    {
+        WrapTFileOutput outfile(tmpfile_list.filename, WrapTFileOutput::mode_t::recreate, true);
+        auto inputfiles = make_shared<WrapTFileInput>(tmpfile_events.filename);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>();
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+        REQUIRE(pm.GetTestPhysicsModule()->seenEvents == 100/3);
+    }
+    PhysicsManager::SaveEventLists = false;
+
+    // and replay it
+    auto inputfiles = make_shared<WrapTFileInput>(tmpfile_list.filename);
+    PhysicsManagerTester pm;
+    pm.AddPhysics<TestPhysics>(true);
+    list< unique_ptr<analysis::input::DataReader> > readers;
+    readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr));
+    REQUIRE_NOTHROW(pm.ReadFrom(move(readers), numeric_limits<long long>::max()));
+    std::shared_ptr<TestPhysics> physics = pm.GetTestPhysicsModule();
+    REQUIRE(physics->seenEvents == 100/3/3);
+    REQUIRE(physics->seenMCTrue > 0);
+}
+
+void dotest_calibrationcache()
+{
+    const unsigned expectedEvents = 221;
+
+    PhysicsManager::SaveCalibrationCache = true;
+
+    tmpfile_t tmpfile_cache;
+    {
+        WrapTFileOutput outfile(tmpfile_cache.filename, WrapTFileOutput::mode_t::recreate, true);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>(true);
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(nullptr, move(unpacker), std_ext::make_unique<Reconstruct>()));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    }
+
+    PhysicsManager::SaveCalibrationCache = false;
+
+    {
+        WrapTFileInput infile(tmpfile_cache.filename);
+        input::CalibrationCache_t cache;
+        REQUIRE(infile.GetObject(input::CalibrationCache_t::TreeName, cache.Tree));
+        // all events are cached, not only the ones the physics class wants to save
+        REQUIRE(cache.Tree->GetEntries() == expectedEvents);
+    }
+
+    // replaying the cache reconstructs the events again
+    auto inputfiles = make_shared<WrapTFileInput>(tmpfile_cache.filename);
+    PhysicsManagerTester pm;
+    pm.AddPhysics<TestPhysics>(true);
+    list< unique_ptr<analysis::input::DataReader> > readers;
+    readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, std_ext::make_unique<Reconstruct>()));
+    pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    TAntHeader header;
+    pm.SetAntHeader(header);
+
+    const std::uint32_t timestamp = 1408221194;
+    REQUIRE(header.FirstID == TID(timestamp, 0u));
+    REQUIRE(header.LastID == TID(timestamp, expectedEvents-1));
+
+    std::shared_ptr<TestPhysics> physics = pm.GetTestPhysicsModule();
+    CHECK(physics->seenEvents == expectedEvents);
+    CHECK(physics->seenTaggerHits == 6272);
+    CHECK(physics->seenCandidates == 864);
+}
+
+void dotest_multifile()
+{
+    const unsigned expectedEvents = 221;
+    const unsigned expectedSaved = expectedEvents/3;
+
+    tmpfile_t tmpfile;
+    {
+        WrapTFileOutput outfile(tmpfile.filename, WrapTFileOutput::mode_t::recreate, true);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>();
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(nullptr, move(unpacker), std_ext::make_unique<Reconstruct>()));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    }
+
+    auto run = [&tmpfile] () {
+        // open the same file twice, as if there were two files with treeEvents
+        auto inputfiles = make_shared<WrapTFileInput>();
+        inputfiles->OpenFile(tmpfile.filename);
+        inputfiles->OpenFile(tmpfile.filename);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<TestPhysics>(true);
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+        return pm.GetTestPhysicsModule()->seenEvents;
+    };
+
+    // all entries of both files
+    REQUIRE(run() == 2*expectedSaved);
+
+    // second half is exactly the second file
+    input::AntReader::EntrySelection.Shard = 1;
+    input::AntReader::EntrySelection.Shards = 2;
+    REQUIRE(run() == expectedSaved);
+
+    // shards are applied within the entry range
+    input::AntReader::EntrySelection.Begin = 10;
+    input::AntReader::EntrySelection.End = 30;
+    REQUIRE(run() == 10);
+
+    input::AntReader::EntrySelection = input::AntReader::EntrySelection_t();
+}
+
 void dotest_raw_nowrite()
 {
     tmpfile_t tmpfile;
@@ -339,3 +654,65 @@ void dotest_runall() {
     }
 
 }
+
+void dotest_neededsections()
+{
+    using Section_t = TEventData::Section_t;
+    const auto all = TEventData::AllSections();
+    const auto candidates = TEventData::Sections_t(Section_t::Candidates);
+
+    tmpfile_t tmpfile;
+    unsigned writtenReadHits = 0;
+    unsigned writtenCandidates = 0;
+    {
+        WrapTFileOutput outfile(tmpfile.filename, WrapTFileOutput::mode_t::recreate, true);
+        PhysicsManagerTester pm;
+        pm.AddPhysics<SectionsPhysics>("Write", all, true, writtenReadHits, writtenCandidates);
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(nullptr, move(unpacker), std_ext::make_unique<Reconstruct>()));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    }
+    REQUIRE(writtenReadHits > 0);
+    REQUIRE(writtenCandidates == 864);
+
+    struct seen_t {
+        unsigned ReadHits = 0;
+        unsigned Candidates = 0;
+    };
+
+    auto run = [&tmpfile] (list<pair<TEventData::Sections_t, seen_t*>> physics) {
+        auto inputfiles = make_shared<WrapTFileInput>(tmpfile.filename);
+        PhysicsManagerTester pm;
+        unsigned n = 0;
+        for(auto& p : physics) {
+            const string name = std_ext::formatter() << "Read" << n++;
+            pm.AddPhysics<SectionsPhysics>(name, p.first, false, p.second->ReadHits, p.second->Candidates);
+        }
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+    };
+
+    TEventData::DeferredSections = TEventData::Sections_t(Section_t::DetectorReadHits);
+
+    // no physics class needs the read hits, so they stay undecoded
+    {
+        seen_t seen;
+        run({{candidates, addressof(seen)}});
+        CHECK(seen.ReadHits == 0);
+        CHECK(seen.Candidates == writtenCandidates);
+    }
+
+    // a physics class reading all sections makes all of them see the read hits
+    {
+        seen_t seen_candidates;
+        seen_t seen_all;
+        run({{candidates, addressof(seen_candidates)}, {all, addressof(seen_all)}});
+        CHECK(seen_candidates.ReadHits == writtenReadHits);
+        CHECK(seen_all.ReadHits == writtenReadHits);
+        CHECK(seen_all.Candidates == writtenCandidates);
+    }
+
+    TEventData::DeferredSections = TEventData::Sections_t();
+}
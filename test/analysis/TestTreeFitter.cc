@@ -128,8 +128,10 @@ void dotest_simple() {
         unsigned nPerms = 0;
         double prb = std_ext::NaN;
         unsigned bestPerm = 0;
+        vector<double> chi2s;
         while(treefitter.NextFit(res)) {
             nPerms++;
+            chi2s.push_back(res.ChiSquare);
             if(res.Status != APLCON::Result_Status_t::Success)
                 continue;
             if(!std_ext::copy_if_greater(prb, res.Probability))
@@ -137,6 +139,21 @@ void dotest_simple() {
             bestPerm = nPerms;
         }
         REQUIRE(nPerms == 12);
+
+        // fitting again with another beam energy and then the same beam energy
+        // must reproduce the results
+        treefitter.PrepareFits(beam->Ek()+10);
+        nPerms = 0;
+        while(treefitter.NextFit(res))
+            nPerms++;
+        REQUIRE(nPerms == 12);
+        treefitter.PrepareFits(beam->Ek());
+        nPerms = 0;
+        while(treefitter.NextFit(res)) {
+            REQUIRE(res.ChiSquare == chi2s.at(nPerms));
+            nPerms++;
+        }
+        REQUIRE(nPerms == 12);
         if(prb != Approx(1.0)) {
             nFailed++;
             continue;
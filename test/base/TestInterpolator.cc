@@ -3,15 +3,21 @@
 
 #include "base/Interpolator.h"
 
-#include "base/detail/interp2d/interp2d.h" // for INDEX_2D
+extern "C" {
+#include "base/detail/interp2d/interp2d_spline.h" // for INDEX_2D and GSL reference
+}
 
 #include <iostream>
+#include <random>
+#include <cmath>
 
 using namespace std;
 using namespace ant;
 
 void dotest_symmetric(Interpolator2D::Type type);
 void dotest_weird();
+void dotest_uniformgrid();
+void dotest_reference(Interpolator2D::Type type, bool uniform);
 
 TEST_CASE("Interpolator2D: Bicubic", "[base]") {
     dotest_symmetric(Interpolator2D::Type::Bicubic);
@@ -26,6 +32,20 @@ TEST_CASE("Interpolator2D: Weird stuff", "[base]") {
     dotest_weird();
 }
 
+TEST_CASE("Interpolator2D: UniformGrid2D", "[base]") {
+    dotest_uniformgrid();
+}
+
+TEST_CASE("Interpolator2D: Bicubic reference", "[base]") {
+    dotest_reference(Interpolator2D::Type::Bicubic, true);
+    dotest_reference(Interpolator2D::Type::Bicubic, false);
+}
+
+TEST_CASE("Interpolator2D: Bilinear reference", "[base]") {
+    dotest_reference(Interpolator2D::Type::Bilinear, true);
+    dotest_reference(Interpolator2D::Type::Bilinear, false);
+}
+
 void dotest_symmetric(Interpolator2D::Type type) {
     const vector<double> x{0.0, 1.0, 2.0, 3.0};
     const vector<double> y{0.0, 1.0, 2.0, 3.0};
@@ -57,5 +77,75 @@ void dotest_weird() {
     REQUIRE_THROWS_AS(Interpolator2D inter({1,2,3,4},{1,2,3,4},{1,2,3}), Interpolator2D::Exception);
 }
 
+void dotest_uniformgrid() {
+    const vector<double> x{0.0, 1.0, 2.0, 3.0};
+    const vector<double> y{0.0, 1.0, 2.0, 3.0};
+    const vector<double> z{1.0, 1.1, 1.2, 1.5,
+                           1.1, 1.2, 1.3, 1.4,
+                           1.2, 1.7, 1.4, 1.5,
+                           1.3, 1.4, 1.5, 1.6};
 
+    // same grid points as bilinear source, so lookup table is exact
+    Interpolator2D bilinear(x,y,z, Interpolator2D::Type::Bilinear);
+    UniformGrid2D grid_bilinear(bilinear, x.size(), y.size());
+    CHECK(grid_bilinear.MaxDeviation(bilinear) == Approx(0.0));
+    CHECK(grid_bilinear.GetPoint(0.5, 2.5) == Approx(bilinear.GetPoint(0.5, 2.5)));
+
+    // outside range is clamped
+    CHECK(grid_bilinear.GetPoint(-1.0, -1.0) == Approx(1.0));
+    CHECK(grid_bilinear.GetPoint(4.0, 4.0) == Approx(1.6));
+
+    // fine grid approximates bicubic
+    Interpolator2D bicubic(x,y,z, Interpolator2D::Type::Bicubic);
+    UniformGrid2D grid_coarse(bicubic, 4, 4);
+    UniformGrid2D grid_fine(bicubic, 100, 100);
+    const auto dev_coarse = grid_coarse.MaxDeviation(bicubic);
+    const auto dev_fine = grid_fine.MaxDeviation(bicubic);
+    CHECK(dev_fine < dev_coarse);
+    CHECK(dev_fine < 1e-3);
+
+    REQUIRE_THROWS_AS(UniformGrid2D(bicubic, 1, 10), UniformGrid2D::Exception);
+}
+
+void dotest_reference(Interpolator2D::Type type, bool uniform) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> rnd(0, 1);
+
+    vector<double> x, y, z;
+    for(unsigned i=0;i<17;i++)
+        x.push_back(i==0 ? -3.7 : x.back() + (uniform ? 0.35 : 0.1 + 0.3*rnd(rng)));
+    for(unsigned j=0;j<11;j++)
+        y.push_back(j==0 ? 0.1 : y.back() + (uniform ? 1.0/3 : 0.05 + rnd(rng)));
+    for(unsigned j=0;j<y.size();j++)
+        for(unsigned i=0;i<x.size();i++)
+            z.push_back(std::sin(x[i])*std::cos(y[j]) + 0.1*rnd(rng));
+
+    Interpolator2D inter(x,y,z, type);
 
+    // plain GSL evaluation without accelerators
+    auto gsl_type = type == Interpolator2D::Type::Bicubic ? interp2d_bicubic : interp2d_bilinear;
+    auto gsl = interp2d_alloc(gsl_type, x.size(), y.size());
+    interp2d_init(gsl, x.data(), y.data(), z.data(), x.size(), y.size());
+
+    vector<double> px, py;
+    for(unsigned k=0;k<5000;k++) {
+        // also exactly on grid points and at the upper border
+        px.push_back(k % 10 == 0 ? x[k % x.size()] : x.front() + rnd(rng)*(x.back()-x.front()));
+        py.push_back(k % 13 == 0 ? y[k % y.size()] : y.front() + rnd(rng)*(y.back()-y.front()));
+    }
+    px.push_back(x.back());
+    py.push_back(y.back());
+
+    vector<double> pz;
+    inter.GetPoints(px, py, pz);
+    REQUIRE(pz.size() == px.size());
+
+    for(unsigned k=0;k<px.size();k++) {
+        const double expected = interp2d_eval(gsl, x.data(), y.data(), z.data(), px[k], py[k], nullptr, nullptr);
+        // bit-for-bit identical
+        REQUIRE(inter.GetPoint(px[k], py[k]) == expected);
+        REQUIRE(pz[k] == expected);
+    }
+
+    interp2d_free(gsl);
+}
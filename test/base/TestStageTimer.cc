@@ -0,0 +1,71 @@
+#include "catch.hpp"
+
+#include "base/StageTimer.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+using namespace ant;
+
+void dotest_disabled();
+void dotest_nested();
+
+TEST_CASE("StageTimer: Disabled", "[base]") {
+    dotest_disabled();
+}
+
+TEST_CASE("StageTimer: Nested", "[base]") {
+    dotest_nested();
+}
+
+void dotest_disabled() {
+    StageTimer::Enabled = false;
+    StageTimer::Reset();
+    const auto id = StageTimer::Register("Disabled");
+    {
+        StageTimer::Scope t(id);
+    }
+    stringstream ss;
+    StageTimer::PrintSummary(ss);
+    REQUIRE(ss.str().find("Disabled") == string::npos);
+}
+
+void dotest_nested() {
+    StageTimer::Enabled = true;
+    StageTimer::TraceFile = "unused";
+
+    // register inner first, the summary should list by first call
+    const auto inner = StageTimer::Register("Inner");
+    const auto outer = StageTimer::Register("Outer");
+    REQUIRE(StageTimer::Register("Inner") == inner);
+    StageTimer::Reset();
+
+    for(int i=0;i<3;i++) {
+        StageTimer::Scope t_outer(outer);
+        StageTimer::Scope t_inner(inner);
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    stringstream summary;
+    StageTimer::PrintSummary(summary);
+    const auto s = summary.str();
+    INFO(s);
+    const auto pos_outer = s.find("\nOuter ");
+    const auto pos_inner = s.find("\n  Inner ");
+    REQUIRE(pos_outer != string::npos);
+    REQUIRE(pos_inner != string::npos);
+    CHECK(pos_outer < pos_inner);
+
+    stringstream trace;
+    StageTimer::WriteTrace(trace);
+    const auto t = trace.str();
+    size_t n = 0;
+    for(auto pos = t.find("\"ph\":\"X\""); pos != string::npos; pos = t.find("\"ph\":\"X\"", pos+1))
+        n++;
+    CHECK(n == 6);
+    CHECK(t.find("{\"traceEvents\":[") == 0);
+
+    StageTimer::Enabled = false;
+    StageTimer::TraceFile.clear();
+}
@@ -1,6 +1,11 @@
 #include "catch.hpp"
 #include "base/Tree.h"
+#include "base/FlatTree.h"
 #include <iostream>
+#include <sstream>
+
+#include "base/cereal/archives/binary.hpp"
+#include "base/cereal/types/vector.hpp"
 
 #include "base/printable.h"
 
@@ -309,3 +314,45 @@ void dotest_perms() {
     REQUIRE_NOTHROW(c->GetUniquePermutations(leaves_my_t, perms, i_leave_offset));
     REQUIRE(perms.size() == 1);
 }
+
+TEST_CASE("Tree: FlatTree", "[base]") {
+    auto a = Tree<int>::MakeNode(0);
+    auto b = a->CreateDaughter(1);
+    b->CreateDaughter(3);
+    b->CreateDaughter(2);
+    a->CreateDaughter(4)->CreateDaughter(5);
+    a->Sort();
+
+    REQUIRE(FlatTree<int>().Empty());
+    REQUIRE(FlatTree<int>().MakeTree() == nullptr);
+    REQUIRE(FlatTree<int>(nullptr).Empty());
+
+    const FlatTree<int> flat(a);
+    REQUIRE(flat.Size() == a->Size());
+
+    // round trip via cereal
+    stringstream ss;
+    {
+        cereal::BinaryOutputArchive ar(ss);
+        ar(flat);
+    }
+    FlatTree<int> flat_read;
+    {
+        cereal::BinaryInputArchive ar(ss);
+        ar(flat_read);
+    }
+    REQUIRE(flat_read.Size() == flat.Size());
+
+    // the tree made again is equal and still sorted,
+    // sorted tree is 0 ( 1 ( 2 3 ) 4 ( 5 ) )
+    auto a_read = flat_read.MakeTree();
+    REQUIRE(a_read->Size() == a->Size());
+    REQUIRE(a_read->Depth() == a->Depth());
+    REQUIRE(a_read->IsEqual(a));
+    REQUIRE(a_read->Daughters().front()->GetParent() == a_read);
+
+    vector<pair<int,size_t>> visited, visited_read;
+    a->Map_level([&visited] (int i, size_t level) { visited.emplace_back(i, level); });
+    a_read->Map_level([&visited_read] (int i, size_t level) { visited_read.emplace_back(i, level); });
+    REQUIRE(visited_read == visited);
+}
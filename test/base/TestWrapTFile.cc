@@ -4,14 +4,18 @@
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
 #include "base/std_ext/memory.h"
+#include "base/OutputProfile.h"
 
 #include "TH1D.h"
+#include "TTree.h"
+#include "TBranch.h"
 
 using namespace std;
 using namespace ant;
 
 void dotest_rw();
 void dotest_r();
+void dotest_profile();
 
 TEST_CASE("WrapTFileInput", "[base]") {
     dotest_r();
@@ -21,6 +25,10 @@ TEST_CASE("WrapTFileOutput", "[base]") {
     dotest_rw();
 }
 
+TEST_CASE("WrapTFileOutput: Profiles", "[base]") {
+    dotest_profile();
+}
+
 void dotest_r() {
     WrapTFileInput input;
     REQUIRE_THROWS_AS(input.OpenFile(string(TEST_BLOBS_DIRECTORY)+"/Acqu_headeronly-small.dat.xz"), WrapTFile::ENotARootFile);
@@ -44,4 +52,45 @@ void dotest_rw() {
     REQUIRE(infile.GetListOf<TH1D>().size() == 2);
 }
 
+void dotest_profile() {
+    REQUIRE_THROWS_AS(OutputProfile::Get("unknown"), OutputProfile::Exception);
+    REQUIRE_THROWS_AS(OutputProfile::SelectForTree("t", "unknown"), OutputProfile::Exception);
+
+    const auto& archive = OutputProfile::Get("archive");
+    const auto& fast = OutputProfile::Get("fast");
+    REQUIRE(archive.GetCompressionSettings() != fast.GetCompressionSettings());
+
+    tmpfile_t tmp;
+
+    OutputProfile::Select("archive");
+    OutputProfile::SelectForTree("t_fast", "fast");
+    {
+        WrapTFileOutput outfile(tmp.filename);
+        double x = 0;
+        auto t_archive = outfile.CreateInside<TTree>("t_archive", "");
+        auto t_fast = outfile.CreateInside<TTree>("t_fast", "");
+        for(auto t : {t_archive, t_fast}) {
+            t->Branch("x", addressof(x));
+            OutputProfile::Apply(*t);
+        }
+
+        CHECK(t_archive->GetBranch("x")->GetCompressionSettings() == archive.GetCompressionSettings());
+        CHECK(t_archive->GetAutoFlush() == archive.AutoFlush);
+        CHECK(t_fast->GetBranch("x")->GetCompressionSettings() == fast.GetCompressionSettings());
+        CHECK(t_fast->GetBranch("x")->GetBasketSize() == fast.BasketSize);
+
+        for(unsigned i=0;i<1000;i++) {
+            x = i;
+            t_archive->Fill();
+            t_fast->Fill();
+        }
+    }
+    OutputProfile::Reset();
+    REQUIRE(OutputProfile::GetSelected("t_fast") == nullptr);
 
+    WrapTFileInput infile(tmp.filename);
+    TTree* t = nullptr;
+    REQUIRE(infile.GetObject("t_fast", t));
+    CHECK(t->GetEntries() == 1000);
+    CHECK(t->GetBranch("x")->GetCompressionSettings() == fast.GetCompressionSettings());
+}
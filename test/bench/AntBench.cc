@@ -0,0 +1,409 @@
+/**
+ * ant-bench measures the throughput of the main stages of the event pipeline.
+ *
+ * Each stage is a Catch test case tagged with [bench], so the usual Catch
+ * command line selects stages (e.g. "ant-bench [reconstruct]"). Additionally,
+ *   --raw <file>    raw input instead of the test blob, e.g. from Ant-fakeRaw
+ *   --pluto <file>  pluto input for the KinFitter stage, e.g. from Ant-mcgun
+ *   --repeat <n>    process the input n times per stage
+ *   --json <file>   write the results machine-readable to file
+ * are understood.
+ */
+
+#define CATCH_CONFIG_RUNNER
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+
+#include "Bench.h"
+
+#include "unpacker/RawFileReader.h"
+#include "unpacker/Unpacker.h"
+#include "reconstruct/Reconstruct.h"
+
+#include "analysis/physics/PhysicsManager.h"
+#include "analysis/physics/AsyncEventWriter.h"
+#include "analysis/physics/Physics.h"
+#include "analysis/input/ant/AntReader.h"
+#include "analysis/input/pluto/PlutoReader.h"
+#include "analysis/utils/fitter/KinFitter.h"
+#include "analysis/utils/fitter/TreeFitter.h"
+#include "analysis/utils/MCFakeReconstructed.h"
+#include "analysis/utils/MCSmear.h"
+#include "analysis/utils/A2GeoAcceptance.h"
+#include "analysis/utils/particle_tools.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include "base/WrapTFile.h"
+#include "base/tmpfile_t.h"
+#include "base/std_ext/math.h"
+#include "base/std_ext/memory.h"
+#include "base/Logger.h"
+#include "base/StageTimer.h"
+
+#include "TBufferFile.h"
+#include "TTree.h"
+#include "TFile.h"
+
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <limits>
+#include <list>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+namespace {
+
+string RawFile() {
+    auto& opts = bench::GetOptions();
+    return opts.RawFile.empty() ? string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz" : opts.RawFile;
+}
+
+string PlutoFile() {
+    auto& opts = bench::GetOptions();
+    return opts.PlutoFile.empty() ? string(TEST_BLOBS_DIRECTORY)+"/Pluto_Etap2g.root" : opts.PlutoFile;
+}
+
+list<TEvent> Unpack(const string& filename) {
+    auto unpacker = Unpacker::Get(filename);
+    list<TEvent> events;
+    while(auto event = unpacker->NextEvent())
+        events.emplace_back(move(event));
+    return events;
+}
+
+struct BenchUncertaintyModel : utils::UncertaintyModel {
+    const utils::A2SimpleGeometry geo;
+
+    virtual utils::Uncertainties_t GetSigmas(const TParticle& particle) const override
+    {
+        utils::Uncertainties_t u{
+            0.05*particle.Ek(),
+            std_ext::degree_to_radian(2.0),
+            std_ext::degree_to_radian(2.0),
+            15 // shower depth in cm
+        };
+        if(geo.DetectorFromAngles(particle) & Detector_t::Type_t::TAPS) {
+            u.sigmaTAPS_Rxy = 8;
+            u.sigmaTAPS_L = 0.5;
+        }
+        else {
+            u.sigmaCB_R = 0.5;
+        }
+        if(particle.Type() == ParticleTypeDatabase::Proton)
+            u.sigmaEk = 0;
+        return u;
+    }
+};
+
+struct fitter_input_t {
+    double BeamE;
+    TParticlePtr Proton;
+    TParticleList Photons;
+};
+
+list<fitter_input_t> ReadFitterInput(const string& filename, bool smeared) {
+    input::PlutoReader reader(make_shared<WrapTFileInput>(filename));
+    utils::MCFakeReconstructed mc_fake(true);
+    utils::MCSmear mc_smear(make_shared<BenchUncertaintyModel>());
+
+    list<fitter_input_t> inputs;
+    while(true) {
+        input::event_t event;
+        if(!reader.ReadNextEvent(event))
+            break;
+        auto particles = mc_fake.Get(event.MCTrue());
+        const auto& protons = particles.Get(ParticleTypeDatabase::Proton);
+        if(protons.size() != 1)
+            continue;
+        fitter_input_t input{
+            event.MCTrue().ParticleTree->Get()->Ek(),
+            protons.front(),
+            particles.Get(ParticleTypeDatabase::Photon)
+        };
+        if(smeared) {
+            input.Proton = mc_smear.Smear(input.Proton);
+            input.Photons = mc_smear.Smear(input.Photons);
+        }
+        inputs.emplace_back(move(input));
+    }
+    return inputs;
+}
+
+/**
+ * @brief The SubStage struct turns the StageTimer scope of the same name into per-event results
+ */
+struct SubStage {
+    const StageTimer::id_t ID;
+    bench::Stage Stage;
+    std::uint64_t calls;
+    double seconds;
+
+    SubStage(const string& name, const string& input) :
+        ID(StageTimer::Register(name)),
+        Stage("Reconstruct/"+name, input),
+        calls(StageTimer::GetCalls(ID)),
+        seconds(StageTimer::GetWallSeconds(ID))
+    {}
+
+    void Update() {
+        const auto c = StageTimer::GetCalls(ID);
+        const auto s = StageTimer::GetWallSeconds(ID);
+        // stages skipped for this event, e.g. by the prefilter, are not counted
+        if(c > calls)
+            Stage.AddEvent(s - seconds);
+        calls = c;
+        seconds = s;
+    }
+};
+
+struct IntervalPhysics : Physics {
+    bench::Stage& stage;
+    IntervalPhysics(bench::Stage& stage_) :
+        Physics("IntervalPhysics", nullptr),
+        stage(stage_)
+    {}
+    virtual void ProcessEvent(const TEvent&, physics::manager_t&) override
+    {
+        stage.Interval();
+    }
+};
+
+}
+
+TEST_CASE("Bench: RawFileReader", "[bench][rawfile]") {
+    const auto filename = RawFile();
+    bench::Stage stage("RawFileReader", filename);
+    vector<char> buffer(0x8000);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        RawFileReader reader;
+        reader.open(filename);
+        while(stage.Measure([&] () {
+                  reader.read(buffer.data(), buffer.size());
+                  return reader.gcount()>0;
+              })) {
+            stage.AddBytes(reader.gcount());
+        }
+    }
+}
+
+TEST_CASE("Bench: Unpacker", "[bench][unpacker]") {
+    test::EnsureSetup();
+    const auto filename = RawFile();
+    const auto filesize = ifstream(filename, ios::binary | ios::ate).tellg();
+    bench::Stage stage("Unpacker", filename);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        auto unpacker = Unpacker::Get(filename);
+        while(stage.Measure([&] () { return bool(unpacker->NextEvent()); })) {}
+        stage.AddBytes(filesize);
+    }
+}
+
+TEST_CASE("Bench: Reconstruct", "[bench][reconstruct]") {
+    test::EnsureSetup();
+    const auto filename = RawFile();
+    // stages register their results on destruction, so the sub-stages
+    // are listed after the total, in the order of the pipeline
+    list<SubStage> substages;
+    for(auto name : {"Updateables", "ReadHits hooks", "BuildHits", "Clustering", "CandidateBuilder"})
+        substages.emplace_back(name, filename);
+    bench::Stage stage("Reconstruct", filename);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        // unpacking is not part of this stage
+        auto events = Unpack(filename);
+        Reconstruct reconstruct;
+        for(auto& event : events)
+            stage.Measure([&] () { reconstruct.DoReconstruct(event.Reconstructed()); });
+
+        // the sub-stages are timed by the StageTimer scopes of Reconstruct,
+        // in a separate pass on a fresh copy of the input, as this adds some overhead
+        Reconstruct reconstruct_stages;
+        StageTimer::Enabled = true;
+        for(auto& event : Unpack(filename)) {
+            reconstruct_stages.DoReconstruct(event.Reconstructed());
+            for(auto& substage : substages)
+                substage.Update();
+        }
+        StageTimer::Enabled = false;
+    }
+}
+
+TEST_CASE("Bench: TEvent I/O", "[bench][tevent]") {
+    test::EnsureSetup();
+    const auto filename = RawFile();
+    auto events = Unpack(filename);
+    Reconstruct reconstruct;
+    for(auto& event : events)
+        reconstruct.DoReconstruct(event.Reconstructed());
+
+    bench::Stage read("TEvent/Read", filename);
+    bench::Stage write("TEvent/Write", filename);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        for(auto& event : events) {
+            TBufferFile buffer(TBuffer::kWrite);
+            write.Measure([&] () { event.Streamer(buffer); });
+            write.AddBytes(buffer.Length());
+
+            TBufferFile inbuffer(TBuffer::kRead, buffer.Length(), buffer.Buffer(), false);
+            TEvent readback;
+            read.Measure([&] () { readback.Streamer(inbuffer); });
+            read.AddBytes(buffer.Length());
+        }
+    }
+}
+
+TEST_CASE("Bench: Save TEvents", "[bench][saveevents]") {
+    test::EnsureSetup();
+    const auto filename = RawFile();
+    auto events = Unpack(filename);
+    Reconstruct reconstruct;
+    for(auto& event : events)
+        reconstruct.DoReconstruct(event.Reconstructed());
+
+    // compare the latency seen by the event loop, closing the output is measured separately
+    // as the asynchronous writer only then copies its baskets
+    bench::Stage sync("SaveEvents/Sync", filename);
+    bench::Stage sync_close("SaveEvents/Sync/Close", filename);
+    bench::Stage async("SaveEvents/Async", filename);
+    bench::Stage async_close("SaveEvents/Async/Close", filename);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        {
+            tmpfile_t tmpfile;
+            auto outfile = std_ext::make_unique<WrapTFileOutput>(tmpfile.filename, WrapTFileOutput::mode_t::recreate, true);
+            auto tree = new TTree("treeEvents","TEvent data");
+            TEvent* eventPtr = nullptr;
+            tree->Branch("data", addressof(eventPtr));
+            for(auto& event : events) {
+                eventPtr = addressof(event);
+                sync.Measure([tree] () { tree->Fill(); });
+            }
+            sync_close.Measure([&outfile, tree] () {
+                tree->ResetBranchAddresses();
+                outfile = nullptr;
+            });
+        }
+        {
+            tmpfile_t tmpfile;
+            auto outfile = std_ext::make_unique<WrapTFileOutput>(tmpfile.filename, WrapTFileOutput::mode_t::recreate, true);
+            AsyncEventWriter writer(tmpfile.filename, gDirectory->GetFile()->GetCompressionSettings());
+            for(auto& event : events)
+                async.Measure([&writer, &event] () { writer.Fill(event); });
+            async_close.Measure([&outfile, &writer] () {
+                writer.Finish(*gDirectory);
+                outfile = nullptr;
+            });
+        }
+    }
+}
+
+TEST_CASE("Bench: KinFitter", "[bench][kinfitter]") {
+    test::EnsureSetup();
+    const auto filename = PlutoFile();
+    const auto inputs = ReadFitterInput(filename, true);
+    REQUIRE_FALSE(inputs.empty());
+
+    utils::KinFitter kinfitter("kinfitter", inputs.front().Photons.size(),
+                               make_shared<BenchUncertaintyModel>(), true);
+    kinfitter.SetZVertexSigma(3.0);
+
+    bench::Stage stage("KinFitter", filename);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        for(auto& input : inputs) {
+            if(input.Photons.size() != inputs.front().Photons.size())
+                continue;
+            stage.Measure([&] () { kinfitter.DoFit(input.BeamE, input.Proton, input.Photons); });
+        }
+    }
+}
+
+TEST_CASE("Bench: TreeFitter", "[bench][treefitter]") {
+    test::EnsureSetup();
+    const auto filename = string(TEST_BLOBS_DIRECTORY)+"/Pluto_EtapOmegaG.root";
+    const auto inputs = ReadFitterInput(filename, true);
+
+    utils::TreeFitter treefitter(
+                "treefitter",
+                ParticleTypeTreeDatabase::Get(ParticleTypeTreeDatabase::Channel::EtaPrime_gOmega_ggPi0_4g),
+                make_shared<BenchUncertaintyModel>(), true);
+    treefitter.SetZVertexSigma(3.0);
+
+    bench::Stage stage("TreeFitter", filename);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        for(auto& input : inputs) {
+            if(input.Photons.size() != 4)
+                continue;
+            // one event comprises all permutations
+            stage.Measure([&] () {
+                treefitter.PrepareFits(input.BeamE, input.Proton, input.Photons);
+                APLCON::Result_t res;
+                while(treefitter.NextFit(res)) {}
+            });
+        }
+    }
+}
+
+TEST_CASE("Bench: PhysicsManager", "[bench][physicsmanager]") {
+    test::EnsureSetup();
+    const auto filename = RawFile();
+    const auto filesize = ifstream(filename, ios::binary | ios::ate).tellg();
+    // the interval between successive events covers the full pipeline,
+    // from unpacking to the physics classes
+    bench::Stage stage("PhysicsManager", filename);
+    for(unsigned i=0;i<bench::GetOptions().Repeat;i++) {
+        PhysicsManager pm;
+        pm.AddPhysics<IntervalPhysics>(stage);
+        list< unique_ptr<input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(
+                                 nullptr, Unpacker::Get(filename), std_ext::make_unique<Reconstruct>()));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+        // the time after the last event until the next repeat is not an event
+        stage.EndInterval();
+        stage.AddBytes(filesize);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    el::Configurations loggerConf;
+    loggerConf.setToDefault();
+    loggerConf.setGlobally(el::ConfigurationType::Enabled, "false");
+    el::Loggers::reconfigureAllLoggers(loggerConf);
+
+    // strip our own options, pass the rest to Catch
+    auto& opts = bench::GetOptions();
+    string jsonfile;
+    vector<char*> catch_args{argv[0]};
+    for(int i=1;i<argc;i++) {
+        auto value = [&] () -> string {
+            if(i+1 >= argc) {
+                cerr << "Option " << argv[i] << " needs a value" << endl;
+                exit(EXIT_FAILURE);
+            }
+            return argv[++i];
+        };
+        if(strcmp(argv[i], "--raw") == 0)
+            opts.RawFile = value();
+        else if(strcmp(argv[i], "--pluto") == 0)
+            opts.PlutoFile = value();
+        else if(strcmp(argv[i], "--repeat") == 0)
+            opts.Repeat = stoul(value());
+        else if(strcmp(argv[i], "--json") == 0)
+            jsonfile = value();
+        else
+            catch_args.push_back(argv[i]);
+    }
+
+    const auto ret = Catch::Session().run(int(catch_args.size()), catch_args.data());
+
+    bench::PrintResults(cout);
+    if(!jsonfile.empty()) {
+        ofstream json(jsonfile);
+        bench::WriteJSON(json);
+    }
+    return ret;
+}
@@ -0,0 +1,181 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <iomanip>
+
+using namespace std;
+using namespace ant;
+using namespace ant::bench;
+
+// count every allocation made by this executable,
+// the benchmark is single-threaded so a plain counter suffices
+
+namespace {
+std::uint64_t nAllocations = 0;
+
+void* counted_malloc(std::size_t size) {
+    ++nAllocations;
+    if(size == 0)
+        size = 1;
+    if(void* p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+}
+
+void* operator new(std::size_t size) { return counted_malloc(size); }
+void* operator new[](std::size_t size) { return counted_malloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+
+std::uint64_t bench::GetAllocations() {
+    return nAllocations;
+}
+
+Options_t& bench::GetOptions() {
+    static Options_t options;
+    return options;
+}
+
+namespace {
+std::list<Result_t>& results() {
+    static std::list<Result_t> r;
+    return r;
+}
+}
+
+const std::list<Result_t>& bench::GetResults() {
+    return results();
+}
+
+Stage::Stage(const string& name, const string& input)
+{
+    result.Stage = name;
+    result.Input = input;
+}
+
+void Stage::Start()
+{
+    allocs_started = nAllocations;
+    running = true;
+    started = clock_t::now();
+}
+
+void Stage::Stop()
+{
+    const auto stopped = clock_t::now();
+    const auto allocs_stopped = nAllocations;
+    running = false;
+
+    const chrono::duration<double> elapsed = stopped - started;
+    result.Seconds += elapsed.count();
+    result.Events++;
+    allocs += allocs_stopped - allocs_started;
+    latencies.push_back(1e6*elapsed.count());
+}
+
+void Stage::AddEvent(double seconds)
+{
+    result.Seconds += seconds;
+    result.Events++;
+    latencies.push_back(1e6*seconds);
+}
+
+void Stage::Interval()
+{
+    if(running)
+        Stop();
+    Start();
+}
+
+void Stage::EndInterval()
+{
+    running = false;
+}
+
+Stage::~Stage()
+{
+    // an interval which was never closed does not represent a complete event
+    EndInterval();
+
+    if(result.Events == 0)
+        return;
+
+    result.AllocsPerEvent = double(allocs)/result.Events;
+
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [this] (double p) {
+        const auto i = static_cast<size_t>(p*(latencies.size()-1) + 0.5);
+        return latencies[i];
+    };
+    result.P50 = percentile(0.50);
+    result.P99 = percentile(0.99);
+
+    results().emplace_back(move(result));
+}
+
+void bench::PrintResults(ostream& s)
+{
+    s << left
+      << setw(20) << "Stage"
+      << right
+      << setw(10) << "Events"
+      << setw(14) << "Events/s"
+      << setw(12) << "MB/s"
+      << setw(14) << "Allocs/Event"
+      << setw(12) << "p50/us"
+      << setw(12) << "p99/us"
+      << "  Input" << '\n';
+    for(auto& r : results()) {
+        s << left
+          << setw(20) << r.Stage
+          << right << fixed
+          << setw(10) << r.Events
+          << setw(14) << setprecision(1) << r.EventsPerSecond()
+          << setw(12) << setprecision(2) << r.BytesPerSecond()/(1 << 20)
+          << setw(14) << setprecision(1) << r.AllocsPerEvent
+          << setw(12) << setprecision(2) << r.P50
+          << setw(12) << setprecision(2) << r.P99
+          << "  " << r.Input << '\n';
+    }
+    s.unsetf(ios_base::floatfield);
+}
+
+namespace {
+string quote(const string& str) {
+    string q = "\"";
+    for(auto c : str) {
+        if(c == '"' || c == '\\')
+            q += '\\';
+        q += c;
+    }
+    return q + "\"";
+}
+}
+
+void bench::WriteJSON(ostream& s)
+{
+    s << "[\n";
+    bool first = true;
+    for(auto& r : results()) {
+        if(!first)
+            s << ",\n";
+        first = false;
+        s << setprecision(10)
+          << "  {"
+          << "\"stage\": " << quote(r.Stage) << ", "
+          << "\"input\": " << quote(r.Input) << ", "
+          << "\"events\": " << r.Events << ", "
+          << "\"bytes\": " << r.Bytes << ", "
+          << "\"seconds\": " << r.Seconds << ", "
+          << "\"events_per_second\": " << r.EventsPerSecond() << ", "
+          << "\"bytes_per_second\": " << r.BytesPerSecond() << ", "
+          << "\"allocs_per_event\": " << r.AllocsPerEvent << ", "
+          << "\"p50_us\": " << r.P50 << ", "
+          << "\"p99_us\": " << r.P99
+          << "}";
+    }
+    s << "\n]\n";
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace ant {
+namespace bench {
+
+/**
+ * @brief Options shared by all benchmark cases, set from the command line
+ */
+struct Options_t {
+    // raw input for the unpacker/reconstruct/physics stages,
+    // for example some output of Ant-fakeRaw
+    std::string RawFile;
+    // pluto input for the KinFitter stage,
+    // for example some output of Ant-mcgun
+    std::string PlutoFile;
+    // how often the input is processed per stage
+    unsigned Repeat = 5;
+};
+
+Options_t& GetOptions();
+
+/**
+ * @brief The Result_t struct summarizes one measured stage
+ */
+struct Result_t {
+    std::string Stage;
+    std::string Input;
+    std::uint64_t Events = 0;
+    std::uint64_t Bytes  = 0;
+    double Seconds = 0;
+    double AllocsPerEvent = 0;
+    // per-event latency in microseconds
+    double P50 = 0;
+    double P99 = 0;
+
+    double EventsPerSecond() const { return Seconds>0 ? Events/Seconds : 0; }
+    double BytesPerSecond() const { return Seconds>0 ? Bytes/Seconds : 0; }
+};
+
+/**
+ * @brief Number of global operator new calls so far, counted by the benchmark executable
+ */
+std::uint64_t GetAllocations();
+
+/**
+ * @brief The Stage class measures per-event latency and allocations of one pipeline stage
+ *
+ * Only the work inside Measure() is accounted for, so preparing the input
+ * (for example unpacking before benchmarking the reconstruction) does not
+ * spoil the numbers. The result is registered when the Stage goes out of scope.
+ */
+class Stage {
+public:
+    Stage(const std::string& name, const std::string& input);
+    ~Stage();
+
+    Stage(const Stage&) = delete;
+    Stage& operator=(const Stage&) = delete;
+
+    template<typename Func>
+    auto Measure(Func&& func) -> decltype(func()) {
+        Start();
+        struct stop_t {
+            Stage& s;
+            ~stop_t() { s.Stop(); }
+        } stop{*this};
+        return func();
+    }
+
+    void AddBytes(std::uint64_t bytes) { result.Bytes += bytes; }
+
+    /**
+     * @brief AddEvent adds an event which was timed elsewhere, for example by a StageTimer,
+     * its allocations are not counted
+     */
+    void AddEvent(double seconds);
+
+    /**
+     * @brief Interval measures the time between successive calls as one event,
+     * useful if the stage is driven by a loop outside of our control
+     */
+    void Interval();
+
+    /**
+     * @brief EndInterval discards the interval started by the last Interval() call,
+     * call it when the loop driving Interval() has finished
+     */
+    void EndInterval();
+
+private:
+    using clock_t = std::chrono::steady_clock;
+    clock_t::time_point started;
+    std::uint64_t allocs_started = 0;
+    bool running = false;
+
+    Result_t result;
+    std::uint64_t allocs = 0;
+    std::vector<double> latencies;
+
+    void Start();
+    void Stop();
+};
+
+const std::list<Result_t>& GetResults();
+
+void PrintResults(std::ostream& s);
+void WriteJSON(std::ostream& s);
+
+}} // namespace ant::bench
@@ -6,8 +6,10 @@
 #include "expconfig/ExpConfig.h"
 
 #include "expconfig/detectors/CB.h"
+#include "expconfig/detectors/PID.h"
 
 #include <iostream>
+#include <algorithm>
 
 using namespace ant;
 using namespace std;
@@ -15,6 +17,7 @@ using namespace std;
 void getdetector();
 void getlastfound();
 void getall();
+void geometry();
 
 TEST_CASE("ExpConfig Get (all)", "[expconfig]") {
     getall();
@@ -25,6 +28,10 @@ TEST_CASE("ExpConfig GetDetector", "[expconfig]") {
     getdetector();
 }
 
+TEST_CASE("ExpConfig Detector geometry", "[expconfig]") {
+    geometry();
+}
+
 void getall() {
     auto setupnames = ExpConfig::Setup::GetNames();
     for(auto setupname : setupnames) {
@@ -48,3 +55,53 @@ void getdetector() {
     REQUIRE_THROWS_AS(ExpConfig::Setup::GetDetector(Detector_t::Type_t::Tagger), ExpConfig::Exception);
 }
 
+
+void geometry() {
+    test::EnsureSetup();
+    auto setup = ExpConfig::Setup::GetLastFound();
+    REQUIRE(setup != nullptr);
+
+    unsigned nClusterDetectors = 0;
+    for(const auto& detector : setup->GetDetectors()) {
+        const auto& geometry = detector->GetGeometry();
+        if(geometry.NChannels == 0)
+            continue;
+        REQUIRE(geometry.NChannels == detector->GetNChannels());
+        for(unsigned ch=0;ch<geometry.NChannels;ch++) {
+            const auto pos = detector->GetPosition(ch);
+            REQUIRE(geometry.Positions[ch] == pos);
+        }
+
+        auto clusterdetector = dynamic_pointer_cast<ClusterDetector_t>(detector);
+        if(!clusterdetector) {
+            REQUIRE(geometry.ClusterElements.empty());
+            continue;
+        }
+        nClusterDetectors++;
+        for(unsigned ch=0;ch<geometry.NChannels;ch++) {
+            auto element = clusterdetector->GetClusterElement(ch);
+            REQUIRE(geometry.ClusterElements[ch] == element);
+            const auto& neighbours = element->Neighbours;
+            unsigned mismatches = 0;
+            for(unsigned other=0;other<geometry.NChannels;other++) {
+                const bool listed = find(neighbours.begin(), neighbours.end(), other) != neighbours.end();
+                if(geometry.IsNeighbour(ch, other) != listed)
+                    mismatches++;
+            }
+            REQUIRE(mismatches == 0);
+        }
+    }
+    // CB and TAPS
+    REQUIRE(nClusterDetectors == 2);
+
+    // the geometry follows a rotation of the PID, and the reference stays valid
+    auto pid = ExpConfig::Setup::GetDetector<expconfig::detector::PID>();
+    const auto& geometry = pid->GetGeometry();
+    const auto phi0 = geometry.Positions[0].Phi();
+    pid->RotateRelative(1.0);
+    REQUIRE(addressof(pid->GetGeometry()) == addressof(geometry));
+    REQUIRE(geometry.Positions[0].Phi() == Approx(pid->GetPosition(0).Phi()));
+    REQUIRE(geometry.Positions[0].Phi() != Approx(phi0));
+    pid->RotateRelative(-1.0);
+    REQUIRE(geometry.Positions[0].Phi() == Approx(phi0));
+}
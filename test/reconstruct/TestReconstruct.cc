@@ -12,6 +12,10 @@
 
 #include "unpacker/Unpacker.h"
 
+#include "base/std_ext/math.h"
+
+#include <cmath>
+
 
 using namespace std;
 using namespace ant;
@@ -23,6 +27,7 @@ void dotest_ignoredelements_raw();
 void dotest_ignoredelements_raw_include();
 void dotest_ignoredelements_geant();
 void dotest_ignoredelements_geant_include();
+void dotest_prefilter();
 
 
 TEST_CASE("Reconstruct: Chain sanity checks", "[reconstruct]") {
@@ -50,6 +55,11 @@ TEST_CASE("Reconstruct: Include ignored elements with geant", "[reconstruct]") {
     dotest_ignoredelements_geant_include();
 }
 
+TEST_CASE("Reconstruct: Prefilter on CB energy sum", "[reconstruct]") {
+    test::EnsureSetup();
+    dotest_prefilter();
+}
+
 template<typename T>
 unsigned getTotalCount(const T& m) {
     unsigned total = 0;
@@ -188,6 +198,54 @@ void dotest_sanity() {
 
 }
 
+void dotest_prefilter() {
+    const auto filename = string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz";
+
+    // reference without prefilter
+    vector<pair<double, unsigned>> reference; // CBEnergySum, nCandidates
+    {
+        REQUIRE(std::isnan(Reconstruct::PrefilterCBEnergySum));
+        auto unpacker = Unpacker::Get(filename);
+        Reconstruct reconstruct;
+        while(auto event = unpacker->NextEvent()) {
+            reconstruct.DoReconstruct(event.Reconstructed());
+            REQUIRE_FALSE(reconstruct.Prefiltered());
+            reference.emplace_back(event.Reconstructed().Trigger.CBEnergySum,
+                                   event.Reconstructed().Candidates.size());
+        }
+    }
+
+    const double threshold = 300;
+    Reconstruct::PrefilterCBEnergySum = threshold;
+
+    auto unpacker = Unpacker::Get(filename);
+    Reconstruct reconstruct;
+    unsigned nPrefiltered = 0;
+    auto it_reference = reference.begin();
+    while(auto event = unpacker->NextEvent()) {
+        REQUIRE(it_reference != reference.end());
+        auto& recon = event.Reconstructed();
+        reconstruct.DoReconstruct(recon);
+        if(it_reference->first < threshold) {
+            REQUIRE(reconstruct.Prefiltered());
+            REQUIRE(recon.Trigger.CBEnergySum == Approx(it_reference->first));
+            REQUIRE(recon.Candidates.empty());
+            REQUIRE(recon.Clusters.empty());
+            nPrefiltered++;
+        }
+        else {
+            REQUIRE_FALSE(reconstruct.Prefiltered());
+            REQUIRE(recon.Candidates.size() == it_reference->second);
+        }
+        ++it_reference;
+    }
+    REQUIRE(it_reference == reference.end());
+    CHECK(nPrefiltered > 0);
+    CHECK(nPrefiltered < reference.size());
+
+    Reconstruct::PrefilterCBEnergySum = std_ext::NaN;
+}
+
 map<Detector_t::Type_t, unsigned> getReconstructedHits(bool geant) {
     auto unpacker = Unpacker::Get(geant ?  string(TEST_BLOBS_DIRECTORY)+"/Geant_with_TID.root" :
                                            string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
@@ -15,11 +15,16 @@ using namespace std;
 using namespace ant;
 
 void dotest();
+void dotest_deferred();
 
 TEST_CASE("TEvent: Write/Read TTree", "[tree]") {
   dotest();
 }
 
+TEST_CASE("TEvent: Deferred sections", "[tree]") {
+  dotest_deferred();
+}
+
 void dotest() {
   tmpfile_t tmpfile;
 
@@ -93,6 +98,20 @@ void dotest() {
   eventdata.ParticleTree->CreateDaughter(particle1);
   eventdata.ParticleTree->CreateDaughter(particle0);
 
+  // scalers with consecutive keys are written packed
+  eventdata.SlowControls.emplace_back(TSlowControl::Type_t::AcquScaler,
+                                      TSlowControl::Validity_t::Backward,
+                                      0, "Scalers", "");
+  for(unsigned i=0;i<47;i++)
+      eventdata.SlowControls.back().Payload_Int.emplace_back(i, 1000*i);
+  eventdata.SlowControls.emplace_back(TSlowControl::Type_t::EpicsOneShot,
+                                      TSlowControl::Validity_t::Forward,
+                                      1234, "Epics", "Some description");
+  eventdata.SlowControls.back().Payload_Int.emplace_back(3, -5);
+  eventdata.SlowControls.back().Payload_Int.emplace_back(7, int64_t(1) << 40);
+  eventdata.SlowControls.back().Payload_Float.emplace_back(0, 1.5);
+  eventdata.SlowControls.back().Payload_String.emplace_back(2, "value");
+
   cout << event << endl;
   cout << *event << endl;
 
@@ -171,4 +190,104 @@ void dotest() {
                         [] (const TCandidate& c) { return c.Detector & Detector_t::Type_t::TAPS; } );
   REQUIRE(taps_cands.size() == 1);
 
+  // check the slowcontrols
+  REQUIRE(readback.SlowControls.size() == 2);
+  const auto& sc0 = readback.SlowControls.front();
+  const auto& sc1 = readback.SlowControls.back();
+  REQUIRE(sc0.GetName() == "Scalers");
+  REQUIRE(sc0.GetNameID() == TSlowControl::InternName("Scalers"));
+  REQUIRE(TSlowControl::NameFromID(sc0.GetNameID()) == "Scalers");
+  REQUIRE(sc0.GetNameID() != sc1.GetNameID());
+  REQUIRE(sc0.Payload_Int.size() == 47);
+  REQUIRE(sc0.Payload_Int.back().Key == 46);
+  REQUIRE(sc0.Payload_Int.back().Value == 46000);
+  REQUIRE(sc1.Timestamp == 1234);
+  REQUIRE(sc1.Description == "Some description");
+  REQUIRE(sc1.Payload_Int.size() == 2);
+  REQUIRE(sc1.Payload_Int.front().Key == 3);
+  REQUIRE(sc1.Payload_Int.front().Value == -5);
+  REQUIRE(sc1.Payload_Int.back().Key == 7);
+  REQUIRE(sc1.Payload_Int.back().Value == (int64_t(1) << 40));
+  REQUIRE(sc1.Payload_Float.front().Value == 1.5);
+  REQUIRE(sc1.Payload_String.front().Key == 2);
+  REQUIRE(sc1.Payload_String.front().Value == "value");
+
+}
+
+void dotest_deferred() {
+  using section_t = TEventData::Section_t;
+
+  // write one event, keep the trees in memory
+  TTree* tree = new TTree("t","");
+  tree->SetDirectory(nullptr);
+  auto event = new TEvent(TID(10));
+  tree->Branch("b", event);
+  auto& eventdata = event->Reconstructed();
+  eventdata.DetectorReadHits.emplace_back();
+  eventdata.DetectorReadHits.emplace_back();
+  eventdata.TaggerHits.emplace_back(10, 1400.0, 1.5);
+  eventdata.Clusters.emplace_back(vec3(1,2,3),
+                                  100, 0.5,
+                                  Detector_t::Type_t::CB,
+                                  127, // central element
+                                  vector<TClusterHit>{TClusterHit()}
+                                  );
+  eventdata.Candidates.emplace_back(
+              Detector_t::Any_t::CB_Apparatus,
+              200,
+              0.0, 0.0, 0.0, // theta/phi/time
+              1, // cluster size
+              0.0, 0.0, // veto/tracker
+              TClusterList{eventdata.Clusters.begin()}
+              );
+  tree->Fill();
+  delete event;
+
+  // read it with deferred sections, and write it again
+  TEventData::DeferredSections = TEventData::Sections_t(section_t::DetectorReadHits) | section_t::Candidates;
+
+  TEvent* readback_event = nullptr;
+  tree->SetBranchAddress("b", &readback_event);
+  REQUIRE(tree->GetEntry(0) > 0);
+
+  TEventData::DeferredSections = TEventData::Sections_t();
+
+  {
+    const auto& readback = readback_event->Reconstructed();
+    REQUIRE(readback.ID == TID(10));
+    REQUIRE(readback.TaggerHits.size() == 1);
+    REQUIRE(readback.DetectorReadHits.empty());
+    REQUIRE(readback.Candidates.empty());
+    REQUIRE_FALSE(readback.IsDecoded(section_t::DetectorReadHits));
+    REQUIRE(readback.IsDecoded(section_t::Tagging));
+  }
+
+  TTree* tree2 = new TTree("t2","");
+  tree2->SetDirectory(nullptr);
+  tree2->Branch("b", readback_event);
+  tree2->Fill();
+
+  // decoding later gives the full event
+  readback_event->Reconstructed().Decode(section_t::Candidates);
+  {
+    const auto& readback = readback_event->Reconstructed();
+    REQUIRE(readback.Candidates.size() == 1);
+    REQUIRE(readback.Clusters.get_ptr_at(0) == readback.Candidates.at(0).Clusters.get_ptr_at(0));
+    REQUIRE(readback.DetectorReadHits.empty());
+  }
+  readback_event->Reconstructed().Decode();
+  REQUIRE(readback_event->Reconstructed().DetectorReadHits.size() == 2);
+
+  // the event written with undecoded sections is complete
+  TEvent* readback_event2 = nullptr;
+  tree2->SetBranchAddress("b", &readback_event2);
+  REQUIRE(tree2->GetEntry(0) > 0);
+  const auto& readback2 = readback_event2->Reconstructed();
+  REQUIRE(readback2.DetectorReadHits.size() == 2);
+  REQUIRE(readback2.TaggerHits.size() == 1);
+  REQUIRE(readback2.Candidates.size() == 1);
+  REQUIRE(readback2.Candidates.at(0).Clusters.size() == 1);
+
+  delete tree;
+  delete tree2;
 }
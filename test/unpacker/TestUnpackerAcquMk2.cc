@@ -3,6 +3,7 @@
 #include "expconfig_helpers.h"
 
 #include "Unpacker.h"
+#include "UnpackerAcqu.h"
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
@@ -14,11 +15,16 @@ using namespace std;
 using namespace ant;
 
 void dotest();
+void dotest_scalersonly();
 
 TEST_CASE("Test UnpackerAcqu: Scaler block", "[unpacker]") {
     dotest();
 }
 
+TEST_CASE("Test UnpackerAcqu: Scalers only", "[unpacker]") {
+    dotest_scalersonly();
+}
+
 void dotest() {
     ant::test::EnsureSetup();
     auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_scalerblock.dat.xz");
@@ -46,7 +52,7 @@ void dotest() {
             for(auto& sc : slowcontrols) {
                 // the test setup and the Acqu test blob uses the end-point tagger,
                 // so there should be corresponding scalers
-                if(sc.Name == "EPT_Scalers") {
+                if(sc.GetName() == "EPT_Scalers") {
                     taggerScalerBlockFound = true;
                     // we know the file is extracted from an EPT run...
                     REQUIRE(sc.Payload_Int.size() == 47);
@@ -61,3 +67,35 @@ void dotest() {
     REQUIRE(nEmptyEvents == 0);
     REQUIRE(taggerScalerBlockFound);
 }
+
+void dotest_scalersonly() {
+    ant::test::EnsureSetup();
+    UnpackerAcqu::ScalersOnly = true;
+    auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_scalerblock.dat.xz");
+    UnpackerAcqu::ScalersOnly = false;
+
+    unsigned nSlowControls = 0;
+    unsigned nEvents = 0;
+    unsigned nHits = 0;
+
+    bool taggerScalerBlockFound = false;
+
+    while(auto event = unpacker->NextEvent()) {
+        nEvents++;
+        nHits += event.Reconstructed().DetectorReadHits.size();
+
+        for(auto& sc : event.Reconstructed().SlowControls) {
+            nSlowControls++;
+            if(sc.GetName() == "EPT_Scalers") {
+                taggerScalerBlockFound = true;
+                REQUIRE(sc.Payload_Int.size() == 47);
+            }
+        }
+    }
+
+    // same slowcontrol as the full unpacking, but far fewer events
+    REQUIRE(nSlowControls == 21);
+    REQUIRE(nEvents < 211);
+    REQUIRE(nHits == 0);
+    REQUIRE(taggerScalerBlockFound);
+}